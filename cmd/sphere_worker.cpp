@@ -0,0 +1,30 @@
+// sphere_worker: a trivial worker for ProcessFunction, answers "<ID> <X_1> ... <X_N>" with "<ID> \sum x_i^2"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <iostream>
+
+
+int main() {
+    std::ios::sync_with_stdio(false);
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream iss(line);
+        std::string id;
+        iss >> id;
+
+        double sum = 0, x;
+        while (iss >> x) {
+            sum += x * x;
+        }
+
+        std::printf("%s %.17g\n", id.c_str(), sum);
+        // flush only when there is nothing more to read, so pipelined requests are answered in chunks
+        if (std::cin.rdbuf()->in_avail() == 0) {
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}
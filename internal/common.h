@@ -2,10 +2,14 @@
 #define FUNCTION_H
 
 #include "random.h"
+#include "sampler.h"
 
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <random>
 #include <vector>
 #include <cmath>
@@ -128,6 +132,8 @@ public:
         }
     }
 
+    bool operator==(const Area& other) const = default;
+
     [[nodiscard]]
     bool contains(const Point& point) const {
         if (point.size() != dimensions()) {
@@ -148,16 +154,113 @@ public:
         return Point::random(min_.size(), min_, max_);
     }
 
+    // the next `count` points of the sampler, mapped onto the area
     [[nodiscard]]
-    std::vector<Point> border_vertexes() const {
-        auto points = std::vector<Point>{{}};
-        for (size_t i = 0; i < dimensions(); i++) {
-            auto next = std::vector<Point>{};
-            for (auto& point : points) {
-                next.push_back(point.appended(min_[i]));
-                next.push_back(point.appended(max_[i]));
+    std::vector<Point> sample(Sampler& sampler, const size_t count) const {
+        auto unit = std::vector<double>(count * dimensions());
+        sampler.generate(count, dimensions(), unit.data());
+        auto ret = std::vector<Point>(count);
+        for (size_t i = 0; i < count; i++) {
+            ret[i].resize(dimensions());
+            for (size_t d = 0; d < dimensions(); d++) {
+                ret[i][d] = percentile(d, unit[i * dimensions() + d]);
             }
-            points = std::move(next);
+        }
+        return ret;
+    }
+
+    // the k-th corner: coordinate d is the maximum one if the bit (n - 1 - d) of k is set
+    [[nodiscard]]
+    Point vertex(const uint64_t k) const {
+        if (k >= vertex_count()) {
+            throw std::invalid_argument(fmt::format("vertex: k={} is out of {} corners", k, vertex_count()));
+        }
+        const auto n = dimensions();
+        auto ret = Point{};
+        ret.resize(n);
+        for (size_t d = 0; d < n; d++) {
+            ret[d] = (k >> (n - 1 - d) & 1) ? max_[d] : min_[d];
+        }
+        return ret;
+    }
+
+    [[nodiscard]]
+    uint64_t vertex_count() const {
+        if (dimensions() >= 64) {
+            throw std::invalid_argument(fmt::format("vertex_count: 2^{} corners don't fit 64 bits", dimensions()));
+        }
+        return uint64_t{1} << dimensions();
+    }
+
+    // VertexIterator: walks the corners in vertex(k) order, reusing a single point.
+    // Moving to k + 1 only rewrites the coordinates of the flipped bits, O(1) amortized.
+    class VertexIterator {
+        const Area* area_ = nullptr;
+        uint64_t index_ = 0;
+        Point point_;
+
+    public:
+        using value_type = Point;
+        using difference_type = std::ptrdiff_t;
+        using reference = const Point&;
+        using pointer = const Point*;
+        using iterator_category = std::forward_iterator_tag;
+
+        VertexIterator() = default;
+
+        VertexIterator(const Area* area, const uint64_t index)
+            : area_(area), index_(index), point_(index < area->vertex_count() ? area->vertex(index) : Point{}) {}
+
+        const Point& operator*() const { return point_; }
+
+        const Point* operator->() const { return &point_; }
+
+        VertexIterator& operator++() {
+            index_ += 1;
+            if (point_.empty()) {
+                return *this;
+            }
+            const auto n = area_->dimensions();
+            for (size_t d = n; d-- > 0;) {
+                const auto bit = index_ >> (n - 1 - d) & 1;
+                point_[d] = bit ? area_->max_[d] : area_->min_[d];
+                if (bit) {
+                    break;
+                }
+            }
+            return *this;
+        }
+
+        VertexIterator operator++(int) {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        bool operator==(const VertexIterator& other) const { return index_ == other.index_; }
+    };
+
+    struct Vertexes {
+        const Area* area;
+
+        [[nodiscard]] VertexIterator begin() const { return {area, 0}; }
+
+        [[nodiscard]] VertexIterator end() const { return {area, area->vertex_count()}; }
+    };
+
+    // all the 2^n corners, generated on demand: for (const auto& corner : area.vertexes()) ...
+    [[nodiscard]]
+    Vertexes vertexes() const {
+        return {this};
+    }
+
+    [[nodiscard]]
+    std::vector<Point> border_vertexes() const {
+        const auto range = vertexes();
+        auto points = std::vector<Point>{};
+        points.reserve(vertex_count());
+        for (const auto& point : range) {
+            points.push_back(point);
         }
         return points;
     }
@@ -167,6 +270,30 @@ public:
         return min_.size();
     }
 
+    [[nodiscard]]
+    const Point& min() const {
+        return min_;
+    }
+
+    [[nodiscard]]
+    const Point& max() const {
+        return max_;
+    }
+
+    // the closest point within the area (projection onto the box)
+    [[nodiscard]]
+    Point clamped(const Point& point) const {
+        if (point.size() != dimensions()) {
+            throw std::invalid_argument("the point is from other dimestion");
+        }
+
+        auto ret = point;
+        for (size_t i = 0; i < ret.size(); i++) {
+            ret[i] = std::clamp(ret[i], min_[i], max_[i]);
+        }
+        return ret;
+    }
+
     [[nodiscard]]
     std::string to_string() const {
         std::ostringstream oss;
@@ -0,0 +1,68 @@
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <cmath>
+
+
+// Dual: a forward-mode automatic differentiation number, a + b*eps where eps^2 = 0.
+// Evaluating f(x + eps) gives f(x) + f'(x)*eps, so `derivative` carries the exact derivative along.
+struct Dual {
+    double value = 0;
+    double derivative = 0;
+
+    Dual() = default;
+
+    /*implicit*/ Dual(const double value, const double derivative = 0) : value(value), derivative(derivative) {}
+
+    static Dual variable(const double value) {
+        return {value, 1};
+    }
+
+    Dual operator-() const { return {-value, -derivative}; }
+
+    friend Dual operator+(const Dual& lhs, const Dual& rhs) {
+        return {lhs.value + rhs.value, lhs.derivative + rhs.derivative};
+    }
+
+    friend Dual operator-(const Dual& lhs, const Dual& rhs) {
+        return {lhs.value - rhs.value, lhs.derivative - rhs.derivative};
+    }
+
+    friend Dual operator*(const Dual& lhs, const Dual& rhs) {
+        return {lhs.value * rhs.value, lhs.derivative * rhs.value + lhs.value * rhs.derivative};
+    }
+
+    friend Dual operator/(const Dual& lhs, const Dual& rhs) {
+        return {
+            lhs.value / rhs.value,
+            (lhs.derivative * rhs.value - lhs.value * rhs.derivative) / (rhs.value * rhs.value)
+        };
+    }
+
+    Dual& operator+=(const Dual& other) { return *this = *this + other; }
+    Dual& operator-=(const Dual& other) { return *this = *this - other; }
+    Dual& operator*=(const Dual& other) { return *this = *this * other; }
+    Dual& operator/=(const Dual& other) { return *this = *this / other; }
+
+    friend bool operator<(const Dual& lhs, const Dual& rhs) { return lhs.value < rhs.value; }
+    friend bool operator>(const Dual& lhs, const Dual& rhs) { return lhs.value > rhs.value; }
+    friend bool operator<=(const Dual& lhs, const Dual& rhs) { return lhs.value <= rhs.value; }
+    friend bool operator>=(const Dual& lhs, const Dual& rhs) { return lhs.value >= rhs.value; }
+
+    friend Dual sin(const Dual& x) { return {std::sin(x.value), std::cos(x.value) * x.derivative}; }
+    friend Dual cos(const Dual& x) { return {std::cos(x.value), -std::sin(x.value) * x.derivative}; }
+    friend Dual exp(const Dual& x) { return {std::exp(x.value), std::exp(x.value) * x.derivative}; }
+    friend Dual log(const Dual& x) { return {std::log(x.value), x.derivative / x.value}; }
+
+    friend Dual sqrt(const Dual& x) {
+        const auto root = std::sqrt(x.value);
+        return {root, x.derivative / (2 * root)};
+    }
+
+    friend Dual pow(const Dual& x, const double p) {
+        return {std::pow(x.value, p), p * std::pow(x.value, p - 1) * x.derivative};
+    }
+};
+
+
+#endif //DUAL_H
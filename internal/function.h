@@ -5,7 +5,11 @@
 #include <cassert>
 
 #include "common.h"
+#include "dual.h"
+#include "interval.h"
+#include "parallel.h"
 
+#include <algorithm>
 #include <limits>
 
 
@@ -26,6 +30,34 @@ public:
 
     virtual double operator()(const Point& point) const = 0;
 
+    // evaluates all the points at once, in parallel on ThreadPool::global();
+    // implementations which aren't thread safe or have a better way to overlap calls override it
+    [[nodiscard]] virtual std::vector<double> evaluate_batch(const std::vector<Point>& points) const {
+        auto ret = std::vector<double>(points.size());
+        auto& pool = ThreadPool::global();
+        pool.parallel_for(points.size(), pool.grain_for(points.size()), [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                ret[i] = operator()(points[i]);
+            }
+        });
+        return ret;
+    }
+
+    // the exact value if it's below the threshold, otherwise any lower bound of it which is not below the threshold,
+    // so the candidates which can't beat an incumbent may be rejected before they are fully evaluated
+    [[nodiscard]] virtual double evaluate_bounded(const Point& point, const double threshold) const {
+        return operator()(point);
+    }
+
+    // the value at the point with one coordinate replaced by x, knowing value = f(point);
+    // (partially) separable functions override it to update only the terms the coordinate takes part in
+    [[nodiscard]] virtual double evaluate_delta(const Point& point, const double value,
+                                                const size_t coordinate, const double x) const {
+        auto moved = point;
+        moved[coordinate] = x;
+        return operator()(moved);
+    }
+
     [[nodiscard]] virtual std::vector<FunctionI::Value> minimal() const = 0;
 
     [[nodiscard]] virtual std::vector<FunctionI::Value> maximum() const = 0;
@@ -34,6 +66,36 @@ public:
 
     [[nodiscard]] virtual std::string name() const = 0;
 
+    // true when value_and_gradient is exact, not a finite difference approximation
+    [[nodiscard]] virtual bool has_gradient() const { return false; }
+
+    // central finite differences, 2n calls; functions knowing their derivatives override it
+    [[nodiscard]] virtual std::pair<double, Point> value_and_gradient(const Point& point) const {
+        auto gradient = Point{};
+        gradient.resize(point.size());
+        auto probe = point;
+        for (size_t i = 0; i < point.size(); i++) {
+            const auto h = 1e-6 * std::max(1.0, std::abs(point[i]));
+            probe[i] = point[i] + h;
+            const auto right = operator()(probe);
+            probe[i] = point[i] - h;
+            const auto left = operator()(probe);
+            probe[i] = point[i];
+            gradient[i] = (right - left) / (2 * h);
+        }
+        return {operator()(point), gradient};
+    }
+
+    // true when bounds() knows more than that the values are real numbers
+    [[nodiscard]] virtual bool has_bounds() const { return false; }
+
+    // encloses the values over the box: every f(x) for x within it is within the result
+    [[nodiscard]] virtual Interval bounds(const Area& box) const { return Interval::whole(); }
+
+    [[nodiscard]] Point gradient(const Point& point) const {
+        return value_and_gradient(point).second;
+    }
+
     [[nodiscard]] FunctionI::Value closest_minimal(const Point& point) const {
         const auto point_extended = point.appended(this->operator()(point));
         auto min_dist = std::numeric_limits<double>::max();
@@ -97,16 +159,105 @@ public:
     }
 };
 
+// DifferentiableFunction: CRTP base for functions written once as `template <typename T> T eval(const std::vector<T>&)`.
+// The same body gives the value (T = double), the exact gradient (T = Dual, one pass per coordinate)
+// and the bounds over a box (T = Interval).
+template <typename Derived>
+class DifferentiableFunction : public Function {
+public:
+    using Function::Function;
+
+    double operator()(const Point& point) const override {
+        return static_cast<const Derived*>(this)->template eval<double>(point);
+    }
+
+    [[nodiscard]] bool has_gradient() const override { return true; }
+
+    [[nodiscard]] std::pair<double, Point> value_and_gradient(const Point& point) const override {
+        auto value = 0.0;
+        auto gradient = Point{};
+        gradient.resize(point.size());
+        auto x = std::vector<Dual>(point.begin(), point.end());
+        for (size_t i = 0; i < point.size(); i++) {
+            x[i].derivative = 1;
+            const auto ret = static_cast<const Derived*>(this)->template eval<Dual>(x);
+            x[i].derivative = 0;
+            value = ret.value;
+            gradient[i] = ret.derivative;
+        }
+        if (point.empty()) {
+            value = operator()(point);
+        }
+        return {value, gradient};
+    }
+
+    [[nodiscard]] bool has_bounds() const override { return true; }
+
+    [[nodiscard]] Interval bounds(const Area& box) const override {
+        auto x = std::vector<Interval>(box.dimensions());
+        for (size_t i = 0; i < x.size(); i++) {
+            x[i] = {box.min()[i], box.max()[i]};
+        }
+        return static_cast<const Derived*>(this)->template eval<Interval>(x);
+    }
+};
+
+// SeparableFunction: CRTP base for f(x) = offset(n) + \sum_i term(x_i), Derived defines
+// `template <typename T> T term(const T&)`, `double offset(size_t n)` and `double term_lower_bound()`.
+// As the terms are bounded from below, evaluate_bounded stops summing once the rest can't get under the threshold.
+template <typename Derived>
+class SeparableFunction : public DifferentiableFunction<Derived> {
+public:
+    using DifferentiableFunction<Derived>::DifferentiableFunction;
+
+    // validates the point's dimension, Derived hides it when the sum is defined for some n only
+    void check(size_t n) const {}
+
+    template <typename T>
+    T eval(const std::vector<T>& point) const {
+        const auto& self = *static_cast<const Derived*>(this);
+        self.check(point.size());
+        T ret = self.offset(point.size());
+        for (const auto& x : point) {
+            ret += self.term(x);
+        }
+        return ret;
+    }
+
+    [[nodiscard]] double evaluate_bounded(const Point& point, const double threshold) const override {
+        const auto& self = *static_cast<const Derived*>(this);
+        self.check(point.size());
+        const auto n = point.size();
+        const auto lower = self.term_lower_bound();
+        double ret = self.offset(n);
+        for (size_t i = 0; i < n; i++) {
+            ret += self.term(point[i]);
+            if (const auto bound = ret + lower * static_cast<double>(n - i - 1); bound >= threshold) {
+                return bound;
+            }
+        }
+        return ret;
+    }
+
+    // O(1): a single term changes
+    [[nodiscard]] double evaluate_delta(const Point& point, const double value,
+                                        const size_t coordinate, const double x) const override {
+        const auto& self = *static_cast<const Derived*>(this);
+        return value - self.term(point[coordinate]) + self.term(x);
+    }
+};
+
 
 // RastriginFunction: https://en.wikipedia.org/wiki/Test_functions_for_optimization
-class RastriginFunction final : public Function {
+class RastriginFunction final : public SeparableFunction<RastriginFunction> {
+    static constexpr double A = 10;
     size_t size_;
 
 public:
-    explicit RastriginFunction(size_t n) : Function(n, {{std::vector(n, 0.0)}}, {}), size_(n) {
-        if (n > 16 || n < 1) {
+    explicit RastriginFunction(size_t n) : SeparableFunction(n, {{std::vector(n, 0.0)}}, {}), size_(n) {
+        if (n > 1000 || n < 1) {
             throw std::invalid_argument(
-                fmt::format("RastriginFunction: dimension={} is too big, should be between 1 and 16", n)
+                fmt::format("RastriginFunction: dimension={} is too big, should be between 1 and 1000", n)
             );
         }
 
@@ -120,13 +271,18 @@ public:
         }
     }
 
-    double operator()(const Point& point) const override {
-        constexpr double A = 10;
-        double ret = A * point.size();
-        for (auto x : point) {
-            ret += sqr(x) - A * std::cos(2 * 3.14 /*good enough*/ * x);
-        }
-        return ret;
+    [[nodiscard]] double offset(const size_t n) const {
+        return A * n;
+    }
+
+    template <typename T>
+    T term(const T& x) const {
+        using std::cos;
+        return sqr(x) - A * cos(2 * 3.14 /*good enough*/ * x);
+    }
+
+    [[nodiscard]] double term_lower_bound() const {
+        return -A;
     }
 
     [[nodiscard]] std::string name() const override {
@@ -136,10 +292,10 @@ public:
 };
 
 // HimmelblauFunction: https://en.wikipedia.org/wiki/Himmelblau%27s_function
-class HimmelblauFunction final : public Function {
+class HimmelblauFunction final : public DifferentiableFunction<HimmelblauFunction> {
 public:
     explicit HimmelblauFunction(size_t n = 2)
-        : Function(n,
+        : DifferentiableFunction(n,
                    {
                        {{3.0, 2.0}},
                        {{-2.805118, 3.131312}},
@@ -155,7 +311,8 @@ public:
         }
     }
 
-    double operator()(const Point& point) const override {
+    template <typename T>
+    T eval(const std::vector<T>& point) const {
         if (point.size() != 2) {
             throw std::invalid_argument(
                 fmt::format("HimmelblauFunction::call: point.dimension={} is invalid, should be exactly 2",
@@ -172,10 +329,10 @@ public:
 
 
 // Styblinski–Tang function: https://en.wikipedia.org/wiki/File:Goldstein_Price_function.pdf
-class StyblinskiTangFunction final : public Function {
+class StyblinskiTangFunction final : public SeparableFunction<StyblinskiTangFunction> {
 public:
     explicit StyblinskiTangFunction(size_t n = 2)
-        : Function(n,
+        : SeparableFunction(n,
                    {
                        {{-2.903534, -2.903534}}
                    },
@@ -188,16 +345,26 @@ public:
         }
     }
 
-    double operator()(const Point& point) const override {
-        if (point.size() != 2) {
+    void check(const size_t n) const {
+        if (n != 2) {
             throw std::invalid_argument(
-                fmt::format("Styblinski–Tang::call: point.dimension={} is invalid, should be exactly 2",
-                            point.size())
+                fmt::format("Styblinski–Tang::call: point.dimension={} is invalid, should be exactly 2", n)
             );
         }
-        const auto x = point[0];
-        const auto y = point[1];
-        return ((sqr(sqr(x)) - 16 * sqr(x) + 5 * x) + (sqr(sqr(y)) - 16 * sqr(y) + 5 * y)) / 2 + 80;
+    }
+
+    [[nodiscard]] double offset(const size_t n) const {
+        return 80;
+    }
+
+    template <typename T>
+    T term(const T& x) const {
+        return (sqr(sqr(x)) - 16 * sqr(x) + 5 * x) / 2;
+    }
+
+    // the term's minimum is at x = -2.903534
+    [[nodiscard]] double term_lower_bound() const {
+        return -39.17;
     }
 
     [[nodiscard]] std::string name() const override {
@@ -0,0 +1,80 @@
+#ifndef FUNCTION_CANCELLABLE_H
+#define FUNCTION_CANCELLABLE_H
+
+#include "function.h"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+
+// thrown out of a method run, when its function has been cancelled
+class Cancelled final : public std::runtime_error {
+public:
+    Cancelled() : std::runtime_error("cancelled") {}
+};
+
+// CancellableFunction: forwards to the wrapped function until the flag is raised, then every call throws Cancelled.
+// Every method evaluates its function, so any of them can be stopped from another thread this way.
+class CancellableFunction final : public Function {
+    std::shared_ptr<Function> function_;
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+
+    void check() const {
+        if (cancelled_->load(std::memory_order_relaxed)) {
+            throw Cancelled{};
+        }
+    }
+
+public:
+    CancellableFunction(std::shared_ptr<Function> function, std::shared_ptr<std::atomic<bool>> cancelled)
+        : Function(function->n(), {}, {}), function_(std::move(function)), cancelled_(std::move(cancelled)) {}
+
+    double operator()(const Point& point) const override {
+        check();
+        return (*function_)(point);
+    }
+
+    [[nodiscard]] std::vector<double> evaluate_batch(const std::vector<Point>& points) const override {
+        check();
+        return function_->evaluate_batch(points);
+    }
+
+    [[nodiscard]] double evaluate_bounded(const Point& point, const double threshold) const override {
+        check();
+        return function_->evaluate_bounded(point, threshold);
+    }
+
+    [[nodiscard]] double evaluate_delta(const Point& point, const double value,
+                                        const size_t coordinate, const double x) const override {
+        check();
+        return function_->evaluate_delta(point, value, coordinate, x);
+    }
+
+    [[nodiscard]] bool has_gradient() const override { return function_->has_gradient(); }
+
+    [[nodiscard]] std::pair<double, Point> value_and_gradient(const Point& point) const override {
+        check();
+        return function_->value_and_gradient(point);
+    }
+
+    [[nodiscard]] bool has_bounds() const override { return function_->has_bounds(); }
+
+    [[nodiscard]] Interval bounds(const Area& box) const override {
+        check();
+        return function_->bounds(box);
+    }
+
+    [[nodiscard]] std::vector<FunctionI::Value> minimal() const override { return function_->minimal(); }
+
+    [[nodiscard]] std::vector<FunctionI::Value> maximum() const override { return function_->maximum(); }
+
+    [[nodiscard]] bool is_dimensions_supported(const size_t n) const override {
+        return function_->is_dimensions_supported(n);
+    }
+
+    [[nodiscard]] std::string name() const override { return function_->name(); }
+};
+
+
+#endif //FUNCTION_CANCELLABLE_H
@@ -0,0 +1,221 @@
+#include "function_process.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <csignal>
+#include <sys/wait.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+
+static void write_all(const int fd, const std::string_view data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        const auto n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw std::runtime_error(fmt::format("ProcessFunction: couldn't write to a worker: {}",
+                                                 std::strerror(errno)));
+        }
+        written += n;
+    }
+}
+
+ProcessFunction::Worker ProcessFunction::spawn(const std::vector<std::string>& command) {
+    int in[2], out[2];
+    if (::pipe2(in, O_CLOEXEC) != 0) {
+        throw std::runtime_error(fmt::format("ProcessFunction: pipe: {}", std::strerror(errno)));
+    }
+    if (::pipe2(out, O_CLOEXEC) != 0) {
+        ::close(in[0]);
+        ::close(in[1]);
+        throw std::runtime_error(fmt::format("ProcessFunction: pipe: {}", std::strerror(errno)));
+    }
+
+    // the child may only call async-signal-safe functions (the parent runs threads), so nothing is allocated there
+    auto argv = std::vector<char*>{};
+    for (const auto& arg : command) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    const auto pid = ::fork();
+    if (pid < 0) {
+        for (const auto fd : {in[0], in[1], out[0], out[1]}) {
+            ::close(fd);
+        }
+        throw std::runtime_error(fmt::format("ProcessFunction: fork: {}", std::strerror(errno)));
+    }
+
+    if (pid == 0) {
+        // dup2 drops O_CLOEXEC from the new descriptors, everything else is closed by exec
+        ::dup2(in[0], STDIN_FILENO);
+        ::dup2(out[1], STDOUT_FILENO);
+        ::execvp(argv[0], argv.data());
+        ::_exit(127);
+    }
+
+    ::close(in[0]);
+    ::close(out[1]);
+    return Worker{pid, in[1], out[0]};
+}
+
+ProcessFunction::ProcessFunction(std::vector<std::string> command, const size_t workers, const size_t in_flight,
+                                 const size_t n)
+    : Function(n, {}, {}), command_(std::move(command)), in_flight_(in_flight) {
+    if (command_.empty()) {
+        throw std::invalid_argument("ProcessFunction: command is empty");
+    }
+    if (workers == 0 || in_flight == 0) {
+        throw std::invalid_argument(fmt::format("ProcessFunction: workers={} and in_flight={} have to be positive",
+                                                workers, in_flight));
+    }
+
+    // a dead worker has to be reported as an error, not kill us
+    std::signal(SIGPIPE, SIG_IGN);
+
+    for (size_t i = 0; i < workers; i++) {
+        workers_.push_back(spawn(command_));
+    }
+}
+
+ProcessFunction::~ProcessFunction() {
+    for (auto& worker : workers_) {
+        if (worker.pid < 0) {
+            continue; // its respawn failed
+        }
+        // EOF on stdin is the signal to exit
+        ::close(worker.in);
+        ::close(worker.out);
+        ::waitpid(worker.pid, nullptr, 0);
+    }
+}
+
+void ProcessFunction::respawn(Worker& worker) const {
+    if (worker.pid >= 0) {
+        ::close(worker.in);
+        ::close(worker.out);
+        ::kill(worker.pid, SIGKILL);
+        ::waitpid(worker.pid, nullptr, 0);
+    }
+    worker = Worker{};
+    worker = spawn(command_);
+}
+
+std::vector<double> ProcessFunction::evaluate_batch(const std::vector<Point>& points) const {
+    std::lock_guard lock(mutex_);
+
+    if (dimensions_ != 0) {
+        for (const auto& point : points) {
+            if (point.size() != dimensions_) {
+                throw std::invalid_argument(
+                    fmt::format("ProcessFunction::call: point.dimension={} is invalid, should be exactly {}",
+                                point.size(), dimensions_));
+            }
+        }
+    }
+
+    try {
+        return exchange(points);
+    } catch (...) {
+        // the workers still owe answers to this batch (or their output is garbage), later batches would read them;
+        // fresh workers don't
+        for (auto& worker : workers_) {
+            if (worker.in_flight > 0 || !worker.buffer.empty()) {
+                try {
+                    respawn(worker);
+                } catch (...) {
+                    // the batch's error is the one to report, this worker fails (and is retried) on its next use
+                }
+            }
+        }
+        throw;
+    }
+}
+
+std::vector<double> ProcessFunction::exchange(const std::vector<Point>& points) const {
+    auto ret = std::vector<double>(points.size(), std::numeric_limits<double>::quiet_NaN());
+    const auto base = next_id_;
+    next_id_ += points.size();
+
+    size_t sent = 0, received = 0;
+    auto polled = std::vector<pollfd>{};
+    auto polled_workers = std::vector<Worker*>{};
+    while (received < points.size()) {
+        for (auto& worker : workers_) {
+            while (worker.in_flight < in_flight_ && sent < points.size()) {
+                worker.in_flight += 1; // counted before writing, a partly written request is owed an answer too
+                write_all(worker.in, fmt::format("{} {}\n", base + sent, fmt::join(points[sent], " ")));
+                sent += 1;
+            }
+        }
+
+        polled.clear();
+        polled_workers.clear();
+        for (auto& worker : workers_) {
+            if (worker.in_flight > 0) {
+                polled.push_back({worker.out, POLLIN, 0});
+                polled_workers.push_back(&worker);
+            }
+        }
+        if (::poll(polled.data(), polled.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(fmt::format("ProcessFunction: poll: {}", std::strerror(errno)));
+        }
+
+        for (size_t i = 0; i < polled.size(); i++) {
+            if (polled[i].revents == 0) {
+                continue;
+            }
+            auto& worker = *polled_workers[i];
+
+            char chunk[4096];
+            const auto n = ::read(worker.out, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                throw std::runtime_error(fmt::format("ProcessFunction: worker '{}' (pid {}) has exited",
+                                                     fmt::join(command_, " "), worker.pid));
+            }
+            worker.buffer.append(chunk, n);
+
+            size_t begin = 0;
+            for (auto end = worker.buffer.find('\n'); end != std::string::npos;
+                 end = worker.buffer.find('\n', begin)) {
+                const auto line = worker.buffer.substr(begin, end - begin);
+                begin = end + 1;
+
+                char* rest = nullptr;
+                const auto id = std::strtoull(line.c_str(), &rest, 10);
+                char* value_end = nullptr;
+                const auto value = std::strtod(rest, &value_end);
+                if (rest == line.c_str() || value_end == rest || id < base || id >= base + points.size()) {
+                    throw std::runtime_error(fmt::format("ProcessFunction: malformed answer '{}'", line));
+                }
+                ret[id - base] = value;
+                worker.in_flight -= 1;
+                received += 1;
+            }
+            worker.buffer.erase(0, begin);
+        }
+    }
+
+    return ret;
+}
+
+std::string ProcessFunction::name() const {
+    return fmt::format("Process function [{}] x{}", fmt::join(command_, " "), workers_.size());
+}
@@ -0,0 +1,68 @@
+#ifndef FUNCTION_PROCESS_H
+#define FUNCTION_PROCESS_H
+
+#include "function.h"
+
+#include <sys/types.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+// ProcessFunction: an objective computed by external worker processes, spoken to over pipes.
+//
+// The protocol is line-based, one request per line:
+//   -> "<ID> <X_1> <X_2> ... <X_N>\n"
+//   <- "<ID> <VALUE>\n"
+// A worker may answer in any order, but it has to answer every request it has read.
+// Up to `in_flight` requests are written to each worker before waiting for the answers,
+// so batches don't pay a full round trip per point, and the batch is spread over all the workers.
+class ProcessFunction final : public Function {
+    struct Worker {
+        pid_t pid = -1;
+        int in = -1;  // worker's stdin
+        int out = -1; // worker's stdout
+        std::string buffer;
+        size_t in_flight = 0;
+    };
+
+    std::vector<std::string> command_;
+    size_t in_flight_;
+    mutable std::vector<Worker> workers_;
+    mutable std::mutex mutex_;
+    mutable std::uint64_t next_id_ = 0;
+
+    static Worker spawn(const std::vector<std::string>& command);
+
+    // replaces the worker with a fresh one, it's killed if it's still running
+    void respawn(Worker& worker) const;
+
+    // sends the batch and collects the answers, the caller holds the lock
+    std::vector<double> exchange(const std::vector<Point>& points) const;
+
+public:
+    // n == 0 means the worker accepts points of any dimension
+    explicit ProcessFunction(std::vector<std::string> command, size_t workers = 1, size_t in_flight = 64,
+                             size_t n = 0);
+
+    ~ProcessFunction() override;
+
+    ProcessFunction(const ProcessFunction&) = delete;
+    ProcessFunction& operator=(const ProcessFunction&) = delete;
+
+    double operator()(const Point& point) const override {
+        return evaluate_batch({point}).front();
+    }
+
+    [[nodiscard]] std::vector<double> evaluate_batch(const std::vector<Point>& points) const override;
+
+    [[nodiscard]] std::string name() const override;
+
+    [[nodiscard]] size_t workers() const {
+        return workers_.size();
+    }
+};
+
+
+#endif //FUNCTION_PROCESS_H
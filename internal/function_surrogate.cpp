@@ -0,0 +1,230 @@
+#include "function_surrogate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+
+// keeps the factor positive definite when points get close
+static constexpr double NUGGET = 1e-10;
+// a point known this well from the others makes the factor ill-conditioned
+static constexpr double CONDITIONING = 1e-8;
+// a point this close (relative to the scale) to a known one is the same point
+static constexpr double DUPLICATE = 1e-9;
+
+double SurrogateFunction::kernel(const Point& lhs, const Point& rhs) const {
+    double r2 = 0;
+    for (size_t i = 0; i < lhs.size(); i++) {
+        r2 += sqr(lhs[i] - rhs[i]);
+    }
+    return 1 / std::sqrt(1 + r2 / sqr(scale_));
+}
+
+bool SurrogateFunction::extend() const {
+    // solve L l = k, the new row is (l, sqrt(1 + nugget - |l|^2))
+    const auto m = cholesky_.size();
+    const auto& point = points_[m];
+    auto row = std::vector<double>(m + 1);
+    double norm = 0;
+    for (size_t i = 0; i < m; i++) {
+        double sum = kernel(points_[i], point);
+        for (size_t j = 0; j < i; j++) {
+            sum -= cholesky_[i][j] * row[j];
+        }
+        row[i] = sum / cholesky_[i][i];
+        norm += sqr(row[i]);
+    }
+    const auto diagonal = 1 + NUGGET - norm;
+    if (!(diagonal > CONDITIONING)) {
+        return false;
+    }
+    row[m] = std::sqrt(diagonal);
+    cholesky_.push_back(std::move(row));
+    return true;
+}
+
+void SurrogateFunction::refit() const {
+    // the scale is half the mean distance between the points
+    double sum = 0;
+    size_t pairs = 0;
+    for (size_t i = 0; i < points_.size(); i++) {
+        for (size_t j = 0; j < i; j++) {
+            sum += points_[i].dist(points_[j]);
+            pairs += 1;
+        }
+    }
+    scale_ = std::max(sum / static_cast<double>(pairs) / 2, 1e-300);
+
+    cholesky_.clear();
+    for (size_t i = 0; i < points_.size();) {
+        if (extend()) {
+            i++;
+        } else {
+            // (almost) a duplicate, it adds nothing but round-off
+            points_.erase(points_.begin() + static_cast<std::ptrdiff_t>(i));
+            values_.erase(values_.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+}
+
+void SurrogateFunction::learn(const Point& point, const double value) const {
+    worst_ = std::max(worst_, value);
+    if (ready()) {
+        // methods evaluate the same points again (e.g. Nelder-Mead's vertices), they add nothing to the model
+        for (const auto& known : points_) {
+            if (known.dist(point) <= DUPLICATE * scale_) {
+                return;
+            }
+        }
+    }
+    points_.push_back(point);
+    values_.push_back(value);
+    weights_.clear();
+    if (!ready()) {
+        if (points_.size() >= 2 * (point.size() + 1)) {
+            refit();
+        }
+        return;
+    }
+    if (points_.size() >= capacity_ || !extend()) {
+        // the search has moved on or closed in, the model follows it with the latest half of the points
+        const auto half = static_cast<std::ptrdiff_t>(points_.size() / 2);
+        points_.erase(points_.begin(), points_.begin() + half);
+        values_.erase(values_.begin(), values_.begin() + half);
+        refit();
+    }
+}
+
+std::pair<double, double> SurrogateFunction::predict(const Point& point) const {
+    const auto m = points_.size();
+    if (weights_.empty()) {
+        mean_ = std::accumulate(values_.begin(), values_.end(), 0.0) / static_cast<double>(m);
+        double variance = 0;
+        for (const auto value : values_) {
+            variance += sqr(value - mean_);
+        }
+        spread_ = std::sqrt(variance / static_cast<double>(m));
+
+        // L L^T w = y - mean
+        weights_.resize(m);
+        for (size_t i = 0; i < m; i++) {
+            double sum = values_[i] - mean_;
+            for (size_t j = 0; j < i; j++) {
+                sum -= cholesky_[i][j] * weights_[j];
+            }
+            weights_[i] = sum / cholesky_[i][i];
+        }
+        for (size_t i = m; i-- > 0;) {
+            double sum = weights_[i];
+            for (size_t j = i + 1; j < m; j++) {
+                sum -= cholesky_[j][i] * weights_[j];
+            }
+            weights_[i] = sum / cholesky_[i][i];
+        }
+    }
+
+    auto k = std::vector<double>(m);
+    double prediction = mean_;
+    for (size_t i = 0; i < m; i++) {
+        k[i] = kernel(points_[i], point);
+        prediction += k[i] * weights_[i];
+    }
+    // kriging variance 1 - k^T K^-1 k = 1 - |L^-1 k|^2
+    double norm = 0;
+    for (size_t i = 0; i < m; i++) {
+        double sum = k[i];
+        for (size_t j = 0; j < i; j++) {
+            sum -= cholesky_[i][j] * k[j];
+        }
+        k[i] = sum / cholesky_[i][i];
+        norm += sqr(k[i]);
+    }
+    const auto sigma = std::sqrt(std::max(0.0, 1 + NUGGET - norm));
+    return {prediction, prediction - kappa_ * sigma * spread_};
+}
+
+double SurrogateFunction::operator()(const Point& point) const {
+    const auto value = (*function_)(point);
+    const auto lock = std::lock_guard(mutex_);
+    statistics_.requested += 1;
+    statistics_.evaluated += 1;
+    learn(point, value);
+    return value;
+}
+
+std::vector<double> SurrogateFunction::evaluate_batch(const std::vector<Point>& points) const {
+    auto selected = std::vector<size_t>(points.size());
+    std::iota(selected.begin(), selected.end(), 0);
+    auto ret = std::vector<double>(points.size());
+    {
+        const auto lock = std::lock_guard(mutex_);
+        statistics_.requested += points.size();
+        const auto count = static_cast<size_t>(std::ceil(fraction_ * static_cast<double>(points.size())));
+        if (ready() && count < points.size()) {
+            auto bounds = std::vector<double>(points.size());
+            for (size_t i = 0; i < points.size(); i++) {
+                std::tie(ret[i], bounds[i]) = predict(points[i]);
+            }
+            std::ranges::sort(selected, [&](const size_t lhs, const size_t rhs) { return bounds[lhs] < bounds[rhs]; });
+            selected.resize(count);
+        }
+        statistics_.evaluated += selected.size();
+        statistics_.predicted += points.size() - selected.size();
+    }
+
+    auto chosen = std::vector<Point>{};
+    for (const auto i : selected) {
+        chosen.push_back(points[i]);
+    }
+    const auto values = function_->evaluate_batch(chosen);
+
+    const auto lock = std::lock_guard(mutex_);
+    auto evaluated = std::vector<bool>(points.size());
+    for (size_t k = 0; k < selected.size(); k++) {
+        ret[selected[k]] = values[k];
+        evaluated[selected[k]] = true;
+        learn(chosen[k], values[k]);
+    }
+    // the predictions are shifted together above every value seen, so a screened point never wins a comparison
+    // and the screened ones are still ranked
+    double lowest = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < points.size(); i++) {
+        if (!evaluated[i]) {
+            lowest = std::min(lowest, ret[i]);
+        }
+    }
+    const auto above = std::nextafter(worst_, std::numeric_limits<double>::infinity());
+    for (size_t i = 0; i < points.size(); i++) {
+        if (!evaluated[i]) {
+            ret[i] = above + (ret[i] - lowest);
+        }
+    }
+    return ret;
+}
+
+double SurrogateFunction::evaluate_bounded(const Point& point, const double threshold) const {
+    {
+        const auto lock = std::lock_guard(mutex_);
+        if (ready()) {
+            if (const auto [prediction, bound] = predict(point); bound >= threshold) {
+                statistics_.requested += 1;
+                statistics_.predicted += 1;
+                return bound;
+            }
+        }
+    }
+    return operator()(point);
+}
+
+double SurrogateFunction::evaluate_delta(const Point& point, const double value,
+                                         const size_t coordinate, const double x) const {
+    const auto ret = function_->evaluate_delta(point, value, coordinate, x);
+    auto moved = point;
+    moved[coordinate] = x;
+    const auto lock = std::lock_guard(mutex_);
+    statistics_.requested += 1;
+    statistics_.evaluated += 1;
+    learn(moved, ret);
+    return ret;
+}
@@ -0,0 +1,117 @@
+#ifndef FUNCTION_SURROGATE_H
+#define FUNCTION_SURROGATE_H
+
+#include "function.h"
+
+#include <limits>
+#include <memory>
+#include <mutex>
+
+
+// SurrogateFunction: screens the points a method asks about with a radial basis function model of the values
+// seen so far, so an expensive function is evaluated at the promising ones only.
+//
+// The model interpolates with inverse multiquadrics, phi(r) = 1 / sqrt(1 + (r / scale)^2), around the mean value;
+// its Cholesky factor grows by a row per evaluation (O(m^2)). When `capacity` is reached or a new row is
+// ill-conditioned (the search has closed in below the scale), the scale is derived anew and the factor is rebuilt
+// from the latest half of the points. Besides the prediction it knows how far a point is from the data (the kriging
+// variance), the lower confidence bound is prediction - kappa * sigma * (spread of the values).
+//  - evaluate_bounded: the points whose lower confidence bound isn't below the threshold are rejected unevaluated;
+//  - evaluate_batch: only the `fraction` of the points with the lowest lower confidence bounds are evaluated,
+//    the others get predictions shifted up together above the worst value ever evaluated, so a screened point
+//    never wins a comparison (a method can't move to it) and the screened ones are still ranked;
+//  - operator(), evaluate_delta, gradients and bounds always evaluate the wrapped function.
+// Nothing is screened until the model has 2 (n + 1) points.
+class SurrogateFunction final : public Function {
+public:
+    struct Statistics {
+        size_t requested = 0; // values asked for
+        size_t evaluated = 0; // values computed by the wrapped function
+        size_t predicted = 0; // values screened out, the evaluations saved
+
+        [[nodiscard]] double saved() const {
+            return requested == 0 ? 0 : static_cast<double>(predicted) / static_cast<double>(requested);
+        }
+    };
+
+private:
+    std::shared_ptr<Function> function_;
+    double fraction_;
+    double kappa_;
+    size_t capacity_;
+
+    mutable std::mutex mutex_;
+    mutable Statistics statistics_;
+    mutable std::vector<Point> points_;
+    mutable std::vector<double> values_;
+    mutable std::vector<std::vector<double>> cholesky_; // the lower triangle, row i has i + 1 entries
+    mutable std::vector<double> weights_;               // empty when outdated
+    mutable double scale_ = 0;                          // 0 until the model is warmed up
+    mutable double mean_ = 0;
+    mutable double spread_ = 0;
+    mutable double worst_ = -std::numeric_limits<double>::infinity(); // of all the values evaluated
+
+    [[nodiscard]] double kernel(const Point& lhs, const Point& rhs) const;
+
+    // appends the row of the first unfactored point to the factor, false when it'd be ill-conditioned;
+    // the caller holds the lock (as for the other helpers)
+    [[nodiscard]] bool extend() const;
+
+    // derives the scale from the points and factors them anew, dropping the (almost) duplicates
+    void refit() const;
+
+    // appends the evaluated point to the model, unless it's a known one
+    void learn(const Point& point, double value) const;
+
+    // {prediction, lower confidence bound}, the model is warmed up
+    [[nodiscard]] std::pair<double, double> predict(const Point& point) const;
+
+    [[nodiscard]] bool ready() const { return scale_ > 0; }
+
+public:
+    // fraction -- of a batch evaluated, kappa -- how much the distance from the data lowers the bound
+    SurrogateFunction(std::shared_ptr<Function> function, const double fraction = 0.25, const double kappa = 1,
+                      const size_t capacity = 400)
+        : Function(function->n(), {}, {}),
+          function_(std::move(function)), fraction_(fraction), kappa_(kappa), capacity_(capacity) {
+        if (!(fraction_ > 0 && fraction_ <= 1)) {
+            throw std::invalid_argument(fmt::format("SurrogateFunction: fraction={} should be in (0, 1]", fraction_));
+        }
+    }
+
+    double operator()(const Point& point) const override;
+
+    [[nodiscard]] std::vector<double> evaluate_batch(const std::vector<Point>& points) const override;
+
+    [[nodiscard]] double evaluate_bounded(const Point& point, double threshold) const override;
+
+    [[nodiscard]] double evaluate_delta(const Point& point, double value, size_t coordinate, double x) const override;
+
+    [[nodiscard]] bool has_gradient() const override { return function_->has_gradient(); }
+
+    [[nodiscard]] std::pair<double, Point> value_and_gradient(const Point& point) const override {
+        return function_->value_and_gradient(point);
+    }
+
+    [[nodiscard]] bool has_bounds() const override { return function_->has_bounds(); }
+
+    [[nodiscard]] Interval bounds(const Area& box) const override { return function_->bounds(box); }
+
+    [[nodiscard]] std::vector<FunctionI::Value> minimal() const override { return function_->minimal(); }
+
+    [[nodiscard]] std::vector<FunctionI::Value> maximum() const override { return function_->maximum(); }
+
+    [[nodiscard]] bool is_dimensions_supported(const size_t n) const override {
+        return function_->is_dimensions_supported(n);
+    }
+
+    [[nodiscard]] std::string name() const override { return function_->name(); }
+
+    [[nodiscard]] Statistics statistics() const {
+        const auto lock = std::lock_guard(mutex_);
+        return statistics_;
+    }
+};
+
+
+#endif //FUNCTION_SURROGATE_H
@@ -0,0 +1,130 @@
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+
+
+// Interval: a closed range [lo, hi] of reals, the result of an operation contains every result for the operands
+// within their ranges. Bounds are rounded outwards by an ulp, so the rounding errors don't break the enclosure.
+// Evaluating a function body on intervals gives bounds of its values over a box (see FunctionI::bounds).
+struct Interval {
+    double lo = 0;
+    double hi = 0;
+
+    Interval() = default;
+
+    /*implicit*/ Interval(const double value) : lo(value), hi(value) {}
+
+    Interval(const double lo, const double hi) : lo(lo), hi(hi) {}
+
+    static Interval whole() {
+        return {-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+    }
+
+    [[nodiscard]] double width() const { return hi - lo; }
+
+    [[nodiscard]] double mid() const { return lo + (hi - lo) / 2; }
+
+    [[nodiscard]] bool contains(const double x) const { return lo <= x && x <= hi; }
+
+    // one ulp outwards
+    static Interval outward(const double lo, const double hi) {
+        return {
+            std::nextafter(lo, -std::numeric_limits<double>::infinity()),
+            std::nextafter(hi, std::numeric_limits<double>::infinity())
+        };
+    }
+
+    Interval operator-() const { return {-hi, -lo}; }
+
+    friend Interval operator+(const Interval& lhs, const Interval& rhs) {
+        return outward(lhs.lo + rhs.lo, lhs.hi + rhs.hi);
+    }
+
+    friend Interval operator-(const Interval& lhs, const Interval& rhs) {
+        return outward(lhs.lo - rhs.hi, lhs.hi - rhs.lo);
+    }
+
+    friend Interval operator*(const Interval& lhs, const Interval& rhs) {
+        const auto a = lhs.lo * rhs.lo, b = lhs.lo * rhs.hi, c = lhs.hi * rhs.lo, d = lhs.hi * rhs.hi;
+        return outward(std::min({a, b, c, d}), std::max({a, b, c, d}));
+    }
+
+    friend Interval operator/(const Interval& lhs, const Interval& rhs) {
+        if (rhs.contains(0)) {
+            return whole();
+        }
+        return lhs * outward(1 / rhs.hi, 1 / rhs.lo);
+    }
+
+    Interval& operator+=(const Interval& other) { return *this = *this + other; }
+    Interval& operator-=(const Interval& other) { return *this = *this - other; }
+    Interval& operator*=(const Interval& other) { return *this = *this * other; }
+    Interval& operator/=(const Interval& other) { return *this = *this / other; }
+
+    // x * x doesn't know both operands are the same, [-1, 2] * [-1, 2] = [-2, 4], sqr gives [0, 4]
+    friend Interval sqr(const Interval& x) {
+        if (x.lo >= 0) {
+            return outward(x.lo * x.lo, x.hi * x.hi);
+        }
+        if (x.hi <= 0) {
+            return outward(x.hi * x.hi, x.lo * x.lo);
+        }
+        return {0, std::nextafter(std::max(x.lo * x.lo, x.hi * x.hi), std::numeric_limits<double>::infinity())};
+    }
+
+    friend Interval cos(const Interval& x) {
+        if (x.width() >= 2 * std::numbers::pi) {
+            return {-1, 1};
+        }
+        auto lo = std::min(std::cos(x.lo), std::cos(x.hi));
+        auto hi = std::max(std::cos(x.lo), std::cos(x.hi));
+        // the maximums are at 2m pi, the minimums at (2m + 1) pi; an extremum next to an end may be counted in,
+        // which only loosens the bounds
+        const auto first = static_cast<long long>(std::ceil(x.lo / std::numbers::pi - 1e-9));
+        const auto last = static_cast<long long>(std::floor(x.hi / std::numbers::pi + 1e-9));
+        for (auto m = first; m <= last; m++) {
+            if (m % 2 == 0) {
+                hi = 1;
+            } else {
+                lo = -1;
+            }
+        }
+        return outward(std::max(lo, -1.0), std::min(hi, 1.0));
+    }
+
+    friend Interval sin(const Interval& x) {
+        return cos(x - std::numbers::pi / 2);
+    }
+
+    friend Interval exp(const Interval& x) { return outward(std::exp(x.lo), std::exp(x.hi)); }
+
+    friend Interval log(const Interval& x) {
+        return outward(x.lo > 0 ? std::log(x.lo) : -std::numeric_limits<double>::infinity(), std::log(x.hi));
+    }
+
+    friend Interval sqrt(const Interval& x) { return outward(std::sqrt(std::max(x.lo, 0.0)), std::sqrt(x.hi)); }
+
+    friend Interval pow(const Interval& x, const double p) {
+        if (p == std::round(p) && p >= 0) {
+            // x^(2k) falls and then rises like x^2, x^(2k + 1) rises
+            if (std::fmod(p, 2) == 0 && x.contains(0)) {
+                return outward(0, std::max(std::pow(x.lo, p), std::pow(x.hi, p)));
+            }
+            const auto a = std::pow(x.lo, p), b = std::pow(x.hi, p);
+            return outward(std::min(a, b), std::max(a, b));
+        }
+        if (x.lo < 0) {
+            throw std::invalid_argument("pow: a non-integer power of an interval with negative numbers");
+        }
+        const auto a = std::pow(x.lo, p), b = std::pow(x.hi, p);
+        return outward(std::min(a, b), std::max(a, b));
+    }
+};
+
+
+#endif //INTERVAL_H
@@ -0,0 +1,195 @@
+#ifndef LINALG_H
+#define LINALG_H
+
+#include "common.h"
+
+#include <cmath>
+#include <optional>
+#include <vector>
+#include <utility>
+
+
+// Matrix: dense row-major matrix, just enough linear algebra for the methods, no BLAS involved
+class Matrix {
+    size_t rows_, cols_;
+    std::vector<double> data_;
+
+public:
+    Matrix(const size_t rows, const size_t cols, const double fill = 0)
+        : rows_(rows), cols_(cols), data_(rows * cols, fill) {}
+
+    static Matrix identity(const size_t n) {
+        auto ret = Matrix(n, n);
+        for (size_t i = 0; i < n; i++) {
+            ret(i, i) = 1;
+        }
+        return ret;
+    }
+
+    [[nodiscard]] size_t rows() const { return rows_; }
+
+    [[nodiscard]] size_t cols() const { return cols_; }
+
+    double& operator()(const size_t row, const size_t col) { return data_[row * cols_ + col]; }
+
+    double operator()(const size_t row, const size_t col) const { return data_[row * cols_ + col]; }
+
+    Point operator*(const Point& x) const {
+        auto ret = Point::rep(rows_, 0);
+        for (size_t i = 0; i < rows_; i++) {
+            const auto* row = &data_[i * cols_];
+            double sum = 0;
+            for (size_t j = 0; j < cols_; j++) {
+                sum += row[j] * x[j];
+            }
+            ret[i] = sum;
+        }
+        return ret;
+    }
+
+    // this = this * scale + factor * u * v^T
+    void scale_and_add_outer(const double scale, const double factor, const Point& u, const Point& v) {
+        for (size_t i = 0; i < rows_; i++) {
+            auto* row = &data_[i * cols_];
+            const auto fu = factor * u[i];
+            for (size_t j = 0; j < cols_; j++) {
+                row[j] = row[j] * scale + fu * v[j];
+            }
+        }
+    }
+};
+
+// Eigen decomposition of a symmetric matrix by the cyclic Jacobi method:
+// returns eigenvalues and the matrix of the corresponding (column) eigenvectors, so a = V * diag(values) * V^T.
+inline std::pair<Point, Matrix> symmetric_eigen(Matrix a, const size_t max_sweeps = 64) {
+    const auto n = a.rows();
+    auto v = Matrix::identity(n);
+
+    for (size_t sweep = 0; sweep < max_sweeps; sweep++) {
+        double off = 0, total = 0;
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                (i == j ? total : off) += sqr(a(i, j));
+            }
+        }
+        if (off <= 1e-22 * (total + off)) {
+            break;
+        }
+
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = p + 1; q < n; q++) {
+                if (a(p, q) == 0) {
+                    continue;
+                }
+                const auto theta = (a(q, q) - a(p, p)) / (2 * a(p, q));
+                const auto t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                const auto c = 1 / std::sqrt(t * t + 1);
+                const auto s = t * c;
+
+                for (size_t k = 0; k < n; k++) {
+                    const auto akp = a(k, p), akq = a(k, q);
+                    a(k, p) = c * akp - s * akq;
+                    a(k, q) = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < n; k++) {
+                    const auto apk = a(p, k), aqk = a(q, k);
+                    a(p, k) = c * apk - s * aqk;
+                    a(q, k) = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < n; k++) {
+                    const auto vkp = v(k, p), vkq = v(k, q);
+                    v(k, p) = c * vkp - s * vkq;
+                    v(k, q) = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    auto values = Point::rep(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        values[i] = a(i, i);
+    }
+    return {values, v};
+}
+
+// Solves a * x = b by Gaussian elimination with partial pivoting, nothing if a is (numerically) singular
+inline std::optional<Point> solve(Matrix a, Point b) {
+    const auto n = a.rows();
+    double scale = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            scale = std::max(scale, std::abs(a(i, j)));
+        }
+    }
+
+    for (size_t col = 0; col < n; col++) {
+        auto pivot = col;
+        for (size_t row = col + 1; row < n; row++) {
+            if (std::abs(a(row, col)) > std::abs(a(pivot, col))) {
+                pivot = row;
+            }
+        }
+        if (!(std::abs(a(pivot, col)) > 1e-12 * scale)) {
+            return {};
+        }
+        if (pivot != col) {
+            for (size_t j = 0; j < n; j++) {
+                std::swap(a(pivot, j), a(col, j));
+            }
+            std::swap(b[pivot], b[col]);
+        }
+        for (size_t row = col + 1; row < n; row++) {
+            const auto factor = a(row, col) / a(col, col);
+            for (size_t j = col; j < n; j++) {
+                a(row, j) -= factor * a(col, j);
+            }
+            b[row] -= factor * b[col];
+        }
+    }
+
+    auto x = Point::rep(n, 0);
+    for (size_t i = n; i-- > 0;) {
+        double sum = b[i];
+        for (size_t j = i + 1; j < n; j++) {
+            sum -= a(i, j) * x[j];
+        }
+        x[i] = sum / a(i, i);
+    }
+    return x;
+}
+
+// the volume of the simplex relative to the one of a cube with its edges, 1 for orthogonal edges, 0 for a flat one
+inline double simplex_regularity(const std::vector<Point>& x) {
+    const auto n = x.size() - 1;
+    const auto dot = [](const Point& lhs, const Point& rhs) {
+        double ret = 0;
+        for (size_t i = 0; i < lhs.size(); i++) {
+            ret += lhs[i] * rhs[i];
+        }
+        return ret;
+    };
+    auto edges = std::vector<Point>{};
+    for (size_t i = 1; i <= n; i++) {
+        edges.push_back(x[i] - x[0]);
+    }
+    // modified Gram–Schmidt, the ratio of the orthogonalized and the original lengths
+    double ret = 1;
+    auto lengths = std::vector<double>(n);
+    for (size_t i = 0; i < n; i++) {
+        lengths[i] = std::sqrt(dot(edges[i], edges[i]));
+    }
+    for (size_t i = 0; i < n; i++) {
+        const auto length = std::sqrt(dot(edges[i], edges[i]));
+        if (!(length > 0) || !(lengths[i] > 0)) {
+            return 0;
+        }
+        ret *= length / lengths[i];
+        for (size_t j = i + 1; j < n; j++) {
+            edges[j] = edges[j] - edges[i] * (dot(edges[i], edges[j]) / sqr(length));
+        }
+    }
+    return std::pow(ret, 1.0 / n);
+}
+
+
+#endif //LINALG_H
@@ -1,6 +1,8 @@
 #ifndef METHOD_H
 #define METHOD_H
 
+#include <functional>
+#include <memory>
 #include <optional>
 
 #include "log.h"
@@ -12,6 +14,28 @@ protected:
     Log log_;
     mutable std::size_t steps_ = 0;
     std::optional<Point> start_;
+    std::function<void(const Point&)> observer_;
+    std::shared_ptr<Sampler> sampler_;
+
+    // appends the point to the path and lets the observer know, use it instead of path.push_back
+    void record(std::vector<Point>& path, Point point) const {
+        path.push_back(std::move(point));
+        if (observer_) {
+            observer_(path.back());
+        }
+    }
+
+    // `count` points of the area from the sampler, independent uniform ones without it
+    [[nodiscard]] std::vector<Point> sample(const Area& where, const size_t count) const {
+        if (sampler_) {
+            return where.sample(*sampler_, count);
+        }
+        auto ret = std::vector<Point>{};
+        for (size_t i = 0; i < count; i++) {
+            ret.push_back(where.random_point());
+        }
+        return ret;
+    }
 
 public:
     virtual ~Method() = default;
@@ -32,6 +56,18 @@ public:
         return this;
     }
 
+    // the observer gets every point of the path as soon as it's found (called from the thread running the method)
+    Method* with_observer(std::function<void(const Point&)> observer) {
+        this->observer_ = std::move(observer);
+        return this;
+    }
+
+    // where the initial and the global points come from, see sampler.h
+    Method* with_sampler(std::shared_ptr<Sampler> sampler) {
+        this->sampler_ = std::move(sampler);
+        return this;
+    }
+
     virtual Method* log(const Log& new_log) {
         log_ = new_log;
         return this;
@@ -0,0 +1,127 @@
+#include "method_branch_and_bound.h"
+
+#include "parallel.h"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+
+namespace {
+struct Box {
+    Area area;
+    double lower;
+    double volume; // relative to the whole area
+
+    bool operator<(const Box& other) const {
+        return lower > other.lower; // std::priority_queue pops the largest
+    }
+};
+
+Point center(const Area& area) {
+    return (area.min() + area.max()) / 2;
+}
+}
+
+Function::Value BranchAndBound::minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const {
+    if (!func->has_bounds()) {
+        throw std::invalid_argument(fmt::format("BranchAndBound: {} has no interval bounds", func->name()));
+    }
+    steps_ = 0;
+    const auto n = where.dimensions();
+    auto& pool = ThreadPool::global();
+    const auto batch = batch_ != 0 ? batch_ : 4 * pool.size();
+
+    auto best = Function::Value{center(where), (*func)(center(where))};
+    if (start_.has_value()) {
+        if (const auto value = (*func)(start_.value()); value < best.second) {
+            best = {start_.value(), value};
+        }
+    }
+    record(path, best.first);
+
+    auto queue = std::priority_queue<Box>{};
+    queue.push({where, func->bounds(where).lo, 1});
+    pruned_ = 0;
+    // the lowest bound of the boxes discarded within the tolerance, the certificate can't be above it
+    double discarded = std::numeric_limits<double>::infinity();
+    size_t boxes = 1;
+    while (!queue.empty() && queue.top().lower < best.second - tolerance_ && boxes < max_boxes_) {
+        steps_ += 1;
+
+        // 1. Bisect the most promising boxes along their widest sides
+        auto halves = std::vector<Box>{};
+        while (!queue.empty() && halves.size() < 2 * batch && queue.top().lower < best.second - tolerance_) {
+            const auto box = queue.top();
+            queue.pop();
+            size_t side = 0;
+            double widest = 0;
+            for (size_t i = 0; i < n; i++) {
+                const auto relative = (box.area.max()[i] - box.area.min()[i]) / (where.max()[i] - where.min()[i]);
+                if (relative > widest) {
+                    widest = relative;
+                    side = i;
+                }
+            }
+            const auto middle = (box.area.min()[side] + box.area.max()[side]) / 2;
+            auto left_max = box.area.max(), right_min = box.area.min();
+            left_max[side] = right_min[side] = middle;
+            halves.push_back({Area{box.area.min(), left_max}, box.lower, box.volume / 2});
+            halves.push_back({Area{right_min, box.area.max()}, box.lower, box.volume / 2});
+        }
+        boxes += halves.size();
+
+        // 2. Bound them and evaluate their centers, in parallel
+        auto centers = std::vector<Point>{};
+        for (const auto& half : halves) {
+            centers.push_back(center(half.area));
+        }
+        pool.parallel_for(halves.size(), 1, [&](const size_t begin, const size_t end) {
+            for (size_t k = begin; k < end; k++) {
+                halves[k].lower = std::max(halves[k].lower, func->bounds(halves[k].area).lo);
+            }
+        });
+        const auto values = func->evaluate_batch(centers);
+        for (size_t k = 0; k < halves.size(); k++) {
+            if (values[k] < best.second) {
+                best = {centers[k], values[k]};
+                record(path, best.first);
+                log_.counted().info(fmt::format("{}, func value \t{},\t on step #{}", best.first, best.second, steps_));
+            }
+        }
+
+        // 3. Keep the halves which may hold a better value
+        for (auto& half : halves) {
+            if (half.lower < best.second - tolerance_) {
+                queue.push(std::move(half));
+            } else {
+                pruned_ += half.volume;
+                discarded = std::min(discarded, half.lower);
+            }
+        }
+    }
+
+    // the lowest bound of the boxes left or discarded, the boxes above the tolerance are as good as discarded
+    const auto left = queue.size();
+    lower_bound_ = std::min({best.second, discarded, queue.empty() ? best.second : queue.top().lower});
+    for (; !queue.empty(); queue.pop()) {
+        if (queue.top().lower >= best.second - tolerance_) {
+            pruned_ += queue.top().volume;
+        }
+    }
+    log_.counted().info(fmt::format("{} boxes, {} left, {}% of the area pruned, the minimum is within [{}, {}]",
+                                    boxes, left, 100 * pruned_, lower_bound_, best.second));
+    return best;
+}
+
+std::pair<std::vector<Point>, Function::Value>
+BranchAndBound::minimal_with_path(Function* func, const Area& where) const {
+    std::vector<Point> path;
+    auto ret = minimal_internal(func, where, path);
+    return {path, ret};
+}
+
+Function::Value BranchAndBound::minimal(Function* func, const Area& where) const {
+    return minimal_with_path(func, where).second;
+}
@@ -0,0 +1,50 @@
+#ifndef BRANCH_AND_BOUND_H
+#define BRANCH_AND_BOUND_H
+
+#include <utility>
+
+#include "common.h"
+#include "log.h"
+#include "method.h"
+
+
+// BranchAndBound: interval branch and bound, https://en.wikipedia.org/wiki/Branch_and_bound.
+// Boxes are taken lowest bound first (see FunctionI::bounds), `batch` at a time: each is bisected along its widest
+// side (relative to the area), the halves are bounded and their centers evaluated in parallel, and the boxes
+// whose lower bound is above the best value found are discarded. It stops when no box may hold a value more than
+// `tolerance` below the result, so the result is certified within the tolerance, or after `max_boxes` boxes.
+// Needs a function with bounds (FunctionI::has_bounds), every DifferentiableFunction has them.
+class BranchAndBound final : public Method {
+    double tolerance_;
+    size_t max_boxes_;
+    size_t batch_;
+    mutable double lower_bound_ = 0;
+    mutable double pruned_ = 0;
+
+public:
+    // batch == 0 -- 4 boxes per thread of ThreadPool::global()
+    explicit BranchAndBound(const Log& logger, const double tolerance = 1e-6, const size_t max_boxes = 1000000,
+                            const size_t batch = 0)
+        : Method(logger.with("BranchAndBound")),
+          tolerance_(tolerance), max_boxes_(max_boxes), batch_(batch) {}
+
+    [[nodiscard]]
+    std::string name() const override { return "Branch and Bound method"; }
+
+    // of the last run: no value within the area is below it
+    [[nodiscard]] double lower_bound() const { return lower_bound_; }
+
+    // of the last run: the fraction of the area's volume which has been discarded
+    [[nodiscard]] double pruned() const { return pruned_; }
+
+    Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
+
+    [[nodiscard]]
+    Function::Value minimal(Function* func, const Area& where) const override;
+
+    [[nodiscard]]
+    std::pair<std::vector<Point>, Function::Value>
+    minimal_with_path(Function* func, const Area& where) const override;
+};
+
+#endif //BRANCH_AND_BOUND_H
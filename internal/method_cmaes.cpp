@@ -0,0 +1,183 @@
+#include "method_cmaes.h"
+
+#include "linalg.h"
+#include "random.h"
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <optional>
+
+
+static double norm(const Point& x) {
+    double ret = 0;
+    for (const auto coord : x) {
+        ret += sqr(coord);
+    }
+    return std::sqrt(ret);
+}
+
+Function::Value CMAES::minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const {
+    steps_ = 0;
+    const auto n = where.dimensions();
+    const auto nd = static_cast<double>(n);
+
+    double width = 0;
+    for (size_t i = 0; i < n; i++) {
+        width = std::max(width, where.max()[i] - where.min()[i]);
+    }
+
+    std::optional<Function::Value> best;
+    size_t evaluations = 0;
+    auto lambda = lambda_ != 0 ? lambda_ : 4 + static_cast<size_t>(3 * std::log(nd));
+
+    for (size_t restart = 0; restart <= restarts_ && evaluations < max_evaluations_; restart++, lambda *= 2) {
+        // strategy parameters, see the tutorial's "Default Parameters" table
+        const auto mu = std::max<size_t>(1, lambda / 2);
+        auto weights = std::vector<double>(mu);
+        for (size_t i = 0; i < mu; i++) {
+            weights[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+        }
+        const auto weights_sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+        double weights_sqr_sum = 0;
+        for (auto& w : weights) {
+            w /= weights_sum;
+            weights_sqr_sum += sqr(w);
+        }
+        const auto mueff = 1 / weights_sqr_sum;
+
+        const auto cc = (4 + mueff / nd) / (nd + 4 + 2 * mueff / nd);
+        const auto cs = (mueff + 2) / (nd + mueff + 5);
+        const auto c1 = 2 / (sqr(nd + 1.3) + mueff);
+        const auto cmu = std::min(1 - c1, 2 * (mueff - 2 + 1 / mueff) / (sqr(nd + 2) + mueff));
+        const auto damps = 1 + 2 * std::max(0.0, std::sqrt((mueff - 1) / (nd + 1)) - 1) + cs;
+        const auto chi_n = std::sqrt(nd) * (1 - 1 / (4 * nd) + 1 / (21 * sqr(nd)));
+        const auto eigen_gap = static_cast<size_t>(lambda / (c1 + cmu) / nd / 10);
+
+        // state
+        auto mean = restart == 0 && start_.has_value() ? where.clamped(start_.value()) : sample(where, 1).front();
+        auto sigma = sigma_ * width;
+        auto c = Matrix::identity(n);
+        auto b = Matrix::identity(n);
+        auto d = Point::rep(n, 1);
+        auto inv_sqrt_c = Matrix::identity(n);
+        auto pc = Point::rep(n, 0);
+        auto ps = Point::rep(n, 0);
+        size_t eigen_generation = 0;
+
+        std::deque<double> recent; // best values of the last generations
+        const auto recent_size = 10 + static_cast<size_t>(std::ceil(30 * nd / lambda));
+
+        log_.counted().info(fmt::format("(re)starting with lambda={} from {}", lambda, mean));
+        record(path, mean);
+
+        for (size_t generation = 0; evaluations < max_evaluations_; generation++) {
+            steps_ += 1;
+
+            // 1. Sample and evaluate the generation as one batch
+            auto xs = std::vector<Point>(lambda);
+            auto ys = std::vector<Point>(lambda);
+            for (size_t k = 0; k < lambda; k++) {
+                auto z = Point::rep(n, 0);
+                for (size_t i = 0; i < n; i++) {
+                    z[i] = d[i] * random::normal();
+                }
+                xs[k] = where.clamped(mean + (b * z) * sigma);
+                ys[k] = (xs[k] - mean) / sigma;
+            }
+            const auto values = func->evaluate_batch(xs);
+            evaluations += lambda;
+
+            auto order = std::vector<size_t>(lambda);
+            std::iota(order.begin(), order.end(), 0);
+            std::ranges::sort(order, [&](const size_t lhs, const size_t rhs) { return values[lhs] < values[rhs]; });
+
+            if (!best.has_value() || values[order[0]] < best->second) {
+                best = {xs[order[0]], values[order[0]]};
+                log_.counted().info(fmt::format("{}, func value \t{},\t on generation #{}",
+                                                best->first, best->second, generation));
+            }
+
+            // 2. Recombination
+            auto y_w = Point::rep(n, 0);
+            for (size_t i = 0; i < mu; i++) {
+                y_w = y_w + ys[order[i]] * weights[i];
+            }
+            mean = mean + y_w * sigma;
+
+            // 3. Step-size control
+            ps = ps * (1 - cs) + (inv_sqrt_c * y_w) * std::sqrt(cs * (2 - cs) * mueff);
+            const auto ps_norm = norm(ps);
+            const auto hsig = ps_norm / std::sqrt(1 - std::pow(1 - cs, 2.0 * (generation + 1))) / chi_n
+                < 1.4 + 2 / (nd + 1);
+
+            // 4. Covariance matrix adaptation
+            pc = pc * (1 - cc) + y_w * (hsig ? std::sqrt(cc * (2 - cc) * mueff) : 0.0);
+            const auto delta = hsig ? 0.0 : cc * (2 - cc);
+            c.scale_and_add_outer(1 - c1 - cmu + c1 * delta, c1, pc, pc);
+            for (size_t i = 0; i < mu; i++) {
+                c.scale_and_add_outer(1, cmu * weights[i], ys[order[i]], ys[order[i]]);
+            }
+            sigma *= std::exp(cs / damps * (ps_norm / chi_n - 1));
+
+            // 5. Decomposition C = B * D^2 * B^T, done lazily, it's O(n^3)
+            if (generation - eigen_generation >= eigen_gap) {
+                eigen_generation = generation;
+                for (size_t i = 0; i < n; i++) {
+                    for (size_t j = 0; j < i; j++) {
+                        c(i, j) = c(j, i) = (c(i, j) + c(j, i)) / 2;
+                    }
+                }
+                auto [eigenvalues, eigenvectors] = symmetric_eigen(c);
+                b = std::move(eigenvectors);
+                for (size_t i = 0; i < n; i++) {
+                    d[i] = std::sqrt(std::max(eigenvalues[i], 1e-300));
+                }
+                for (size_t i = 0; i < n; i++) {
+                    for (size_t j = 0; j < n; j++) {
+                        double sum = 0;
+                        for (size_t k = 0; k < n; k++) {
+                            sum += b(i, k) * b(j, k) / d[k];
+                        }
+                        inv_sqrt_c(i, j) = sum;
+                    }
+                }
+            }
+
+            record(path, where.clamped(mean));
+
+            // 6. Termination of the run
+            const auto [min_d, max_d] = std::ranges::minmax(d);
+            if (sigma * max_d < tolerance_) {
+                log_.counted().info(fmt::format("EXITING run: sigma * max(D) < {}, on generation #{}",
+                                                tolerance_, generation));
+                break;
+            }
+            recent.push_back(values[order[0]]);
+            if (recent.size() > recent_size) {
+                recent.pop_front();
+                if (const auto [lo, hi] = std::ranges::minmax(recent); hi - lo < tolerance_) {
+                    log_.counted().info(fmt::format("EXITING run: values range < {}, on generation #{}",
+                                                    tolerance_, generation));
+                    break;
+                }
+            }
+            if (max_d > 1e7 * min_d) {
+                log_.counted().info(fmt::format("EXITING run: cond(C) > 1e14, on generation #{}", generation));
+                break;
+            }
+        }
+    }
+
+    return best.value();
+}
+
+std::pair<std::vector<Point>, Function::Value> CMAES::minimal_with_path(Function* func, const Area& where) const {
+    std::vector<Point> path;
+    auto ret = minimal_internal(func, where, path);
+    return {path, ret};
+}
+
+Function::Value CMAES::minimal(Function* func, const Area& where) const {
+    return minimal_with_path(func, where).second;
+}
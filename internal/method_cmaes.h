@@ -0,0 +1,44 @@
+#ifndef CMAES_H
+#define CMAES_H
+
+#include <utility>
+
+#include "common.h"
+#include "log.h"
+#include "method.h"
+
+
+// https://en.wikipedia.org/wiki/CMA-ES, follows "The CMA Evolution Strategy: A Tutorial" by N. Hansen.
+// Rank-mu and rank-one covariance updates, cumulative step-size adaptation and IPOP restarts
+// (the population doubles on every restart). Each generation is evaluated as one parallel batch.
+// Samples are repaired into the Area before being evaluated.
+class CMAES final : public Method {
+    double tolerance_;
+    size_t restarts_;
+    size_t max_evaluations_;
+    double sigma_;
+    size_t lambda_;
+
+public:
+    // sigma -- initial step size as a fraction of the widest side of the area,
+    // lambda == 0 -- the default population size 4 + 3 ln(n)
+    explicit CMAES(const Log& logger, const double tolerance = 1e-8, const size_t restarts = 4,
+                   const size_t max_evaluations = 100000, const double sigma = 0.3, const size_t lambda = 0)
+        : Method(logger.with("CMAES")),
+          tolerance_(tolerance), restarts_(restarts), max_evaluations_(max_evaluations),
+          sigma_(sigma), lambda_(lambda) {}
+
+    [[nodiscard]]
+    std::string name() const override { return "CMA-ES method"; }
+
+    Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
+
+    [[nodiscard]]
+    Function::Value minimal(Function* func, const Area& where) const override;
+
+    [[nodiscard]]
+    std::pair<std::vector<Point>, Function::Value>
+    minimal_with_path(Function* func, const Area& where) const override;
+};
+
+#endif //CMAES_H
@@ -0,0 +1,95 @@
+#include "method_differential_evolution.h"
+
+#include "population.h"
+#include "random.h"
+
+#include <algorithm>
+
+
+Function::Value DifferentialEvolution::minimal_internal(Function* func, const Area& where,
+                                                        std::vector<Point>& path) const {
+    steps_ = 0;
+    const auto n = where.dimensions();
+    const auto size = size_ != 0 ? std::max<size_t>(size_, 4) : std::max<size_t>(20, 10 * n);
+
+    auto population = sampler_ ? Population::sample(size, where, *sampler_) : Population::random(size, where);
+    if (start_.has_value()) {
+        const auto start = where.clamped(start_.value());
+        for (size_t d = 0; d < n; d++) {
+            population.coordinate(d)[0] = start[d];
+        }
+    }
+    auto values = population.evaluate(*func);
+
+    auto best = static_cast<size_t>(std::ranges::min_element(values) - values.begin());
+    record(path, population.point(best));
+
+    auto trial = Population(size, n);
+    auto r1 = std::vector<size_t>(size), r2 = std::vector<size_t>(size), r3 = std::vector<size_t>(size);
+    auto forced = std::vector<size_t>(size);
+    auto chance = std::vector<double>(size);
+    auto index = std::uniform_int_distribution<size_t>(0, size - 1);
+    auto dimension = std::uniform_int_distribution<size_t>(0, n - 1);
+
+    for (size_t generation = 1; generation <= max_; generation++) {
+        steps_ += 1;
+
+        // 1. Draw the donors: three distinct individuals, distinct from the target
+        for (size_t i = 0; i < size; i++) {
+            do { r1[i] = index(random::engine()); } while (r1[i] == i);
+            do { r2[i] = index(random::engine()); } while (r2[i] == i || r2[i] == r1[i]);
+            do { r3[i] = index(random::engine()); } while (r3[i] == i || r3[i] == r1[i] || r3[i] == r2[i]);
+            forced[i] = dimension(random::engine());
+        }
+
+        // 2. Mutation and binomial crossover, coordinate by coordinate over the whole population
+        for (size_t d = 0; d < n; d++) {
+            for (size_t i = 0; i < size; i++) {
+                chance[i] = random::gen(0, 1);
+            }
+            const auto* x = population.coordinate(d);
+            auto* t = trial.coordinate(d);
+            for (size_t i = 0; i < size; i++) {
+                const auto mutant = x[r1[i]] + f_ * (x[r2[i]] - x[r3[i]]);
+                t[i] = chance[i] < cr_ || forced[i] == d ? mutant : x[i];
+            }
+        }
+        trial.clamp(where);
+
+        // 3. Selection
+        const auto trial_values = trial.evaluate(*func);
+        for (size_t i = 0; i < size; i++) {
+            if (trial_values[i] <= values[i]) {
+                population.assign(i, trial, i);
+                values[i] = trial_values[i];
+            }
+        }
+
+        if (const auto current = static_cast<size_t>(std::ranges::min_element(values) - values.begin());
+            values[current] < values[best]) {
+            best = current;
+            record(path, population.point(best));
+            log_.counted().info(fmt::format("{}, func value \t{},\t on generation #{}",
+                                            path.back(), values[best], generation));
+        }
+
+        if (const auto [lo, hi] = std::ranges::minmax(values); hi - lo < tolerance_) {
+            log_.counted().info(fmt::format("EXITING: population values range < {}, on generation #{}",
+                                            tolerance_, generation));
+            break;
+        }
+    }
+
+    return {population.point(best), values[best]};
+}
+
+std::pair<std::vector<Point>, Function::Value>
+DifferentialEvolution::minimal_with_path(Function* func, const Area& where) const {
+    std::vector<Point> path;
+    auto ret = minimal_internal(func, where, path);
+    return {path, ret};
+}
+
+Function::Value DifferentialEvolution::minimal(Function* func, const Area& where) const {
+    return minimal_with_path(func, where).second;
+}
@@ -0,0 +1,41 @@
+#ifndef DIFFERENTIAL_EVOLUTION_H
+#define DIFFERENTIAL_EVOLUTION_H
+
+#include <utility>
+
+#include "common.h"
+#include "log.h"
+#include "method.h"
+
+
+// https://en.wikipedia.org/wiki/Differential_evolution, DE/rand/1/bin scheme.
+// The population is kept as a structure of arrays (see Population), every generation is one parallel batch.
+class DifferentialEvolution final : public Method {
+    size_t size_;
+    double f_;
+    double cr_;
+    double tolerance_;
+    size_t max_;
+
+public:
+    // size == 0 -- 10 individuals per dimension (at least 20)
+    // 0 < f <= 2, 0 <= cr <= 1
+    explicit DifferentialEvolution(const Log& logger, const size_t size = 0, const double f = 0.5,
+                                   const double cr = 0.9, const double tolerance = 1e-8, const size_t max = 1000)
+        : Method(logger.with("DifferentialEvolution")),
+          size_(size), f_(f), cr_(cr), tolerance_(tolerance), max_(max) {}
+
+    [[nodiscard]]
+    std::string name() const override { return "Differential Evolution method"; }
+
+    Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
+
+    [[nodiscard]]
+    Function::Value minimal(Function* func, const Area& where) const override;
+
+    [[nodiscard]]
+    std::pair<std::vector<Point>, Function::Value>
+    minimal_with_path(Function* func, const Area& where) const override;
+};
+
+#endif //DIFFERENTIAL_EVOLUTION_H
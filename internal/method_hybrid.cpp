@@ -0,0 +1,218 @@
+#include "method_hybrid.h"
+
+#include "method_nelder_mead.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+
+
+namespace {
+// thrown out of a descent which has spent its budget
+class Exhausted final : public std::exception {};
+
+// keeps the best point a descent has seen and the trail of its improvements, stops it after `budget` evaluations
+class BudgetFunction final : public Function {
+    Function* function_;
+    size_t budget_;
+    mutable std::mutex mutex_;
+    mutable size_t evaluations_ = 0;
+    mutable std::vector<Point> trail_;
+    mutable Function::Value best_{{}, std::numeric_limits<double>::infinity()};
+
+    // charges `count` evaluations, unless they'd overspend the budget
+    void charge(const size_t count) const {
+        const auto lock = std::lock_guard(mutex_);
+        if (evaluations_ + count > budget_) {
+            throw Exhausted{};
+        }
+        evaluations_ += count;
+    }
+
+    // keeps the exact value an evaluation found
+    void keep(const Point& point, const double value) const {
+        const auto lock = std::lock_guard(mutex_);
+        if (value < best_.second) {
+            best_ = {point, value};
+            trail_.push_back(point);
+        }
+    }
+
+public:
+    BudgetFunction(Function* function, const size_t budget)
+        : Function(function->n(), {}, {}), function_(function), budget_(budget) {}
+
+    double operator()(const Point& point) const override {
+        charge(1);
+        const auto value = (*function_)(point);
+        keep(point, value);
+        return value;
+    }
+
+    // a batch costs an evaluation per point
+    [[nodiscard]] std::vector<double> evaluate_batch(const std::vector<Point>& points) const override {
+        charge(points.size());
+        const auto values = function_->evaluate_batch(points);
+        for (size_t i = 0; i < points.size(); i++) {
+            keep(points[i], values[i]);
+        }
+        return values;
+    }
+
+    // a value not below the threshold is only a bound, it isn't kept
+    [[nodiscard]] double evaluate_bounded(const Point& point, const double threshold) const override {
+        charge(1);
+        const auto value = function_->evaluate_bounded(point, threshold);
+        if (value < threshold) {
+            keep(point, value);
+        }
+        return value;
+    }
+
+    [[nodiscard]] double evaluate_delta(const Point& point, const double value,
+                                        const size_t coordinate, const double x) const override {
+        charge(1);
+        const auto ret = function_->evaluate_delta(point, value, coordinate, x);
+        auto moved = point;
+        moved[coordinate] = x;
+        keep(moved, ret);
+        return ret;
+    }
+
+    [[nodiscard]] bool has_gradient() const override { return function_->has_gradient(); }
+
+    // an exact gradient costs an evaluation, finite differences are charged call by call
+    [[nodiscard]] std::pair<double, Point> value_and_gradient(const Point& point) const override {
+        if (!function_->has_gradient()) {
+            return Function::value_and_gradient(point);
+        }
+        charge(1);
+        auto ret = function_->value_and_gradient(point);
+        keep(point, ret.first);
+        return ret;
+    }
+
+    [[nodiscard]] std::vector<FunctionI::Value> minimal() const override { return function_->minimal(); }
+
+    [[nodiscard]] std::vector<FunctionI::Value> maximum() const override { return function_->maximum(); }
+
+    [[nodiscard]] bool has_bounds() const override { return function_->has_bounds(); }
+
+    [[nodiscard]] Interval bounds(const Area& box) const override { return function_->bounds(box); }
+
+    [[nodiscard]] bool is_dimensions_supported(const size_t n) const override {
+        return function_->is_dimensions_supported(n);
+    }
+
+    [[nodiscard]] std::string name() const override { return function_->name(); }
+
+    [[nodiscard]] size_t evaluations() const { return evaluations_; }
+
+    [[nodiscard]] const Function::Value& best() const { return best_; }
+
+    [[nodiscard]] const std::vector<Point>& trail() const { return trail_; }
+};
+}
+
+Function::Value Hybrid::minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const {
+    steps_ = 0;
+    const auto n = where.dimensions();
+    auto width = Point::rep(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        width[i] = where.max()[i] - where.min()[i];
+    }
+    const auto distance = [&](const Point& lhs, const Point& rhs) {
+        double ret = 0;
+        for (size_t i = 0; i < n; i++) {
+            ret += sqr((lhs[i] - rhs[i]) / width[i]);
+        }
+        return std::sqrt(ret);
+    };
+
+    // 1. Global sampling
+    auto points = sample(where, samples_);
+    if (start_.has_value()) {
+        points.insert(points.begin(), start_.value());
+    }
+    const auto values = func->evaluate_batch(points);
+    auto order = std::vector<size_t>(points.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&](const size_t lhs, const size_t rhs) { return values[lhs] < values[rhs]; });
+    if (start_.has_value()) {
+        std::ranges::rotate(order.begin(), std::ranges::find(order, 0), std::ranges::find(order, 0) + 1);
+    }
+
+    // 2. The best points of distinct basins
+    auto starts = std::vector<Point>{};
+    for (const auto i : order) {
+        if (starts.size() == basins_) {
+            break;
+        }
+        if (std::ranges::all_of(starts, [&](const Point& s) { return distance(s, points[i]) >= separation_; })) {
+            starts.push_back(points[i]);
+            log_.counted().info(fmt::format("basin #{} at {}, func value \t{}", starts.size(), points[i], values[i]));
+        }
+    }
+    if (starts.empty()) {
+        throw std::invalid_argument("Hybrid needs at least one sample and one basin");
+    }
+    for (const auto& point : starts) {
+        record(path, point);
+    }
+
+    // 3. Local descents, one per basin
+    auto functions = std::vector<std::unique_ptr<BudgetFunction>>{};
+    auto steps = std::vector<size_t>(starts.size());
+    for (size_t k = 0; k < starts.size(); k++) {
+        functions.push_back(std::make_unique<BudgetFunction>(func, budget_));
+    }
+    ThreadPool::global().parallel_for(starts.size(), 1, [&](const size_t begin, const size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            // a right-angled simplex at the start, flipped where it would leave the area
+            auto simplex = std::vector<Point>{starts[k]};
+            for (size_t i = 0; i < n; i++) {
+                auto vertex = starts[k];
+                vertex[i] += separation_ / 2 * width[i];
+                if (vertex[i] > where.max()[i]) {
+                    vertex[i] -= separation_ * width[i];
+                }
+                simplex.push_back(std::move(vertex));
+            }
+            auto local = NelderMead(Log::null(), tolerance_).with(std::move(simplex));
+            try {
+                static_cast<void>(local.minimal(functions[k].get(), where));
+            } catch (const Exhausted&) {
+                // the best point seen is the result
+            }
+            steps[k] = local.steps_took();
+        }
+    });
+
+    size_t winner = 0;
+    for (size_t k = 0; k < starts.size(); k++) {
+        steps_ += steps[k];
+        const auto& [point, value] = functions[k]->best();
+        log_.counted().info(fmt::format("descent #{} {}, func value \t{},\t after {} evaluations",
+                                        k + 1, point, value, functions[k]->evaluations()));
+        if (value < functions[winner]->best().second) {
+            winner = k;
+        }
+    }
+    for (const auto& point : functions[winner]->trail()) {
+        record(path, point);
+    }
+    return functions[winner]->best();
+}
+
+std::pair<std::vector<Point>, Function::Value> Hybrid::minimal_with_path(Function* func, const Area& where) const {
+    std::vector<Point> path;
+    auto ret = minimal_internal(func, where, path);
+    return {path, ret};
+}
+
+Function::Value Hybrid::minimal(Function* func, const Area& where) const {
+    return minimal_with_path(func, where).second;
+}
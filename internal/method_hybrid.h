@@ -0,0 +1,44 @@
+#ifndef HYBRID_H
+#define HYBRID_H
+
+#include <utility>
+
+#include "common.h"
+#include "log.h"
+#include "method.h"
+
+
+// Hybrid: a global-local pipeline. The first stage evaluates `samples` points of the area as one parallel batch
+// (from the sampler, see with_sampler), the second one runs NelderMead from the best `basins` of them which are
+// at least `separation` apart, all the descents at once on ThreadPool::global(), each within its own budget.
+// The start point, if any, is always one of the basins.
+class Hybrid final : public Method {
+    size_t samples_;
+    size_t basins_;
+    size_t budget_;
+    double tolerance_;
+    double separation_;
+
+public:
+    // budget -- evaluations of a single descent,
+    // separation -- distance between the basins, as a fraction of the sides of the area, it's the size of
+    // the initial simplexes too
+    explicit Hybrid(const Log& logger, const size_t samples = 1000, const size_t basins = 4,
+                    const size_t budget = 10000, const double tolerance = 1e-6, const double separation = 0.1)
+        : Method(logger.with("Hybrid")),
+          samples_(samples), basins_(basins), budget_(budget), tolerance_(tolerance), separation_(separation) {}
+
+    [[nodiscard]]
+    std::string name() const override { return "Hybrid (sampling + Nelder Mead) method"; }
+
+    Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
+
+    [[nodiscard]]
+    Function::Value minimal(Function* func, const Area& where) const override;
+
+    [[nodiscard]]
+    std::pair<std::vector<Point>, Function::Value>
+    minimal_with_path(Function* func, const Area& where) const override;
+};
+
+#endif //HYBRID_H
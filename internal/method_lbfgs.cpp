@@ -0,0 +1,204 @@
+#include "method_lbfgs.h"
+
+#include <deque>
+#include <limits>
+
+
+static double dot(const Point& lhs, const Point& rhs) {
+    double ret = 0;
+    for (size_t i = 0; i < lhs.size(); i++) {
+        ret += lhs[i] * rhs[i];
+    }
+    return ret;
+}
+
+// max t, such that x + t * d stays within the area
+static double max_step(const Area& where, const Point& x, const Point& d) {
+    auto ret = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < x.size(); i++) {
+        if (d[i] > 0) {
+            ret = std::min(ret, (where.max()[i] - x[i]) / d[i]);
+        } else if (d[i] < 0) {
+            ret = std::min(ret, (where.min()[i] - x[i]) / d[i]);
+        }
+    }
+    return std::max(ret, 0.0);
+}
+
+// infinity norm of the projected gradient, zero at a (box constrained) stationary point
+static double projected_gradient_norm(const Area& where, const Point& x, const Point& g) {
+    double ret = 0;
+    const auto projected = where.clamped(x - g);
+    for (size_t i = 0; i < x.size(); i++) {
+        ret = std::max(ret, abs(projected[i] - x[i]));
+    }
+    return ret;
+}
+
+namespace {
+struct Sample {
+    double t;
+    Point x;
+    double value;
+    Point gradient;
+    double slope;
+};
+}
+
+Function::Value LBFGS::minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const {
+    steps_ = 0;
+    log_.info(func->has_gradient() ? "using exact gradients" : "using finite difference gradients");
+
+    auto x = where.clamped(start_.has_value() ? start_.value() : sample(where, 1).front());
+    auto [value, g] = func->value_and_gradient(x);
+    record(path, x);
+
+    std::deque<std::pair<Point, Point>> history; // (s_k, y_k)
+    const auto n = x.size();
+
+    for (size_t iter = 0; iter < max_; iter++) {
+        if (const auto norm = projected_gradient_norm(where, x, g); norm < tolerance_) {
+            log_.counted().info(fmt::format("EXITING: |projected gradient| = {} < {}, on iteration #{}",
+                                            norm, tolerance_, iter));
+            break;
+        }
+        steps_ += 1;
+
+        // variables pushed against their bounds don't move
+        auto fixed = std::vector<bool>(n);
+        for (size_t i = 0; i < n; i++) {
+            fixed[i] = (x[i] <= where.min()[i] && g[i] > 0) || (x[i] >= where.max()[i] && g[i] < 0);
+        }
+
+        // two-loop recursion: d = -H * g
+        auto q = g;
+        for (size_t i = 0; i < n; i++) {
+            if (fixed[i]) { q[i] = 0; }
+        }
+        auto alphas = std::vector<double>(history.size());
+        for (size_t k = history.size(); k-- > 0;) {
+            const auto& [s, y] = history[k];
+            alphas[k] = dot(s, q) / dot(s, y);
+            q = q - y * alphas[k];
+        }
+        if (!history.empty()) {
+            const auto& [s, y] = history.back();
+            q = q * (dot(s, y) / dot(y, y));
+        }
+        for (size_t k = 0; k < history.size(); k++) {
+            const auto& [s, y] = history[k];
+            const auto beta = dot(y, q) / dot(s, y);
+            q = q + s * (alphas[k] - beta);
+        }
+        // a variable on its bound doesn't move out of the area either when the direction (not the gradient) says so
+        auto project = [&](Point& direction) {
+            for (size_t i = 0; i < n; i++) {
+                if (fixed[i] || (x[i] <= where.min()[i] && direction[i] < 0)
+                    || (x[i] >= where.max()[i] && direction[i] > 0)) {
+                    direction[i] = 0;
+                }
+            }
+        };
+        auto d = -q;
+        project(d);
+
+        auto slope = dot(g, d);
+        if (!(slope < 0)) {
+            // the projected steepest descent is a descent direction unless x is stationary
+            log_.debug("not a descent direction, resetting the memory");
+            history.clear();
+            d = -g;
+            project(d);
+            slope = dot(g, d);
+        }
+
+        const auto t_max = max_step(where, x, d);
+        if (t_max <= 0 || !(slope < 0)) {
+            log_.counted().info(fmt::format("EXITING: no feasible descent direction, on iteration #{}", iter));
+            break;
+        }
+
+        // line search (strong Wolfe conditions), Nocedal & Wright, algorithms 3.5 and 3.6
+        auto sample = [&](const double t) -> Sample {
+            auto point = where.clamped(x + d * t);
+            auto [v, grad] = func->value_and_gradient(point);
+            const auto s = dot(grad, d);
+            return {t, std::move(point), v, std::move(grad), s};
+        };
+        auto armijo = [&](const Sample& s) { return s.value <= value + c1_ * s.t * slope; };
+        auto curvature = [&](const Sample& s) { return abs(s.slope) <= -c2_ * slope; };
+
+        auto zoom = [&](Sample lo, Sample hi) -> Sample {
+            for (size_t j = 0; j < 40; j++) {
+                auto mid = sample((lo.t + hi.t) / 2);
+                if (!armijo(mid) || mid.value >= lo.value) {
+                    hi = std::move(mid);
+                    continue;
+                }
+                if (curvature(mid)) {
+                    return mid;
+                }
+                if (mid.slope * (hi.t - lo.t) >= 0) {
+                    hi = lo;
+                }
+                lo = std::move(mid);
+            }
+            return lo;
+        };
+
+        // the first step isn't scaled by the memory yet, so keep it of a sane size
+        auto t = history.empty() ? std::min(1.0, 1.0 / std::sqrt(dot(d, d))) : 1.0;
+        t = std::min(t, t_max);
+        auto prev = Sample{0, x, value, g, slope};
+        Sample next;
+        for (size_t j = 0;; j++) {
+            auto current = sample(t);
+            if (!armijo(current) || (j > 0 && current.value >= prev.value)) {
+                next = zoom(std::move(prev), std::move(current));
+                break;
+            }
+            if (curvature(current) || t >= t_max || j >= 40) {
+                next = std::move(current);
+                break;
+            }
+            if (current.slope >= 0) {
+                next = zoom(std::move(current), std::move(prev));
+                break;
+            }
+            prev = std::move(current);
+            t = std::min(2 * t, t_max);
+        }
+
+        if (next.t == 0 || !(next.value <= value)) {
+            log_.counted().info(fmt::format("EXITING: line search has failed, on iteration #{}", iter));
+            break;
+        }
+
+        auto s = next.x - x;
+        auto y = next.gradient - g;
+        if (dot(s, y) > 1e-12 * dot(y, y)) {
+            history.emplace_back(std::move(s), std::move(y));
+            if (history.size() > memory_) {
+                history.pop_front();
+            }
+        }
+
+        log_.counted().info(fmt::format("{} -> {}, func value \t{},\t step {}", x, next.x, next.value, next.t));
+        x = std::move(next.x);
+        value = next.value;
+        g = std::move(next.gradient);
+        record(path, x);
+    }
+
+    return {x, value};
+}
+
+std::pair<std::vector<Point>, Function::Value> LBFGS::minimal_with_path(Function* func, const Area& where) const {
+    std::vector<Point> path;
+    auto ret = minimal_internal(func, where, path);
+    return {path, ret};
+}
+
+Function::Value LBFGS::minimal(Function* func, const Area& where) const {
+    return minimal_with_path(func, where).second;
+}
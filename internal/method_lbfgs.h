@@ -0,0 +1,44 @@
+#ifndef LBFGS_H
+#define LBFGS_H
+
+#include <utility>
+
+#include "common.h"
+#include "log.h"
+#include "method.h"
+
+
+// https://en.wikipedia.org/wiki/Limited-memory_BFGS
+// Quasi-Newton method: the inverse Hessian is approximated by the last `memory` steps (two-loop recursion),
+// the step length is chosen by a line search satisfying the strong Wolfe conditions.
+// Box constraints of the Area are respected L-BFGS-B style: variables on a bound with the gradient pointing
+// outwards are frozen, and a step never goes further than the nearest bound.
+// Uses exact gradients if the function has them (see FunctionI::has_gradient) and finite differences otherwise.
+class LBFGS final : public Method {
+    size_t memory_;
+    double tolerance_;
+    size_t max_;
+    double c1_;
+    double c2_;
+
+public:
+    // 0 < c1 < c2 < 1
+    explicit LBFGS(const Log& logger, const double tolerance = 1e-6, const size_t memory = 7,
+                   const size_t max = 1000, const double c1 = 1e-4, const double c2 = 0.9)
+        : Method(logger.with("LBFGS")),
+          memory_(memory), tolerance_(tolerance), max_(max), c1_(c1), c2_(c2) {}
+
+    [[nodiscard]]
+    std::string name() const override { return "L-BFGS method"; }
+
+    Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
+
+    [[nodiscard]]
+    Function::Value minimal(Function* func, const Area& where) const override;
+
+    [[nodiscard]]
+    std::pair<std::vector<Point>, Function::Value>
+    minimal_with_path(Function* func, const Area& where) const override;
+};
+
+#endif //LBFGS_H
@@ -1,7 +1,10 @@
 #include "method_nelder_mead.h"
 
+#include "linalg.h"
+
 #include <ranges>
 #include <algorithm>
+#include <map>
 
 using namespace std;
 
@@ -86,19 +89,24 @@ Function::Value NelderMead::minimal_internal(Function* func, vector<Point>& x) c
 }
 
 Function::Value
-NelderMead::minimal_internal_(Function* function, std::vector<Point>& x, std::vector<Point>& path) const {
+NelderMead::minimal_internal_(Function* function, std::vector<Point>& x, std::vector<Point>& path,
+                              const std::function<bool(const std::vector<Point>&)>& interrupt) const {
     auto func = [function](const auto& p) { return (*function)(p); };
     auto return_or_go_deeper = [&, prev_x = x]() -> Function::Value {
         steps_ += 1;
         auto mse = function->MSE(x, prev_x);
-        path.push_back(x[0]);
+        record(path, x[0]);
         if (mse < tolerance_) {
             log_.counted().info(fmt::format("{} < {} (MSE < tolerance) at {}, therefore exiting",
                                             mse, tolerance_, x[0]));
             return {x[0], func(x[0])};
         }
+        if (interrupt && interrupt(x)) {
+            const auto best = ranges::min_element(x, {}, func);
+            return {*best, func(*best)};
+        }
         log_.counted().info(fmt::format("{}\t -> {} (MSE: {})", prev_x, x, mse));
-        return minimal_internal_(function, x, path);
+        return minimal_internal_(function, x, path, interrupt);
     };
 
     // 1. Order
@@ -149,3 +157,183 @@ NelderMead::minimal_internal_(Function* function, std::vector<Point>& x, std::ve
     }
     return return_or_go_deeper();
 }
+
+namespace {
+// counts the evaluations of the wrapped function, for the budget of the restarts; the core evaluates the same
+// vertices again and again (ordering, the MSE, the interrupt), so the values are remembered and only distinct
+// points are evaluated and counted
+class CountingFunction final : public Function {
+    Function* function_;
+    mutable std::map<Point, double> known_; // at most the budget of points
+    mutable size_t evaluations_ = 0;
+
+public:
+    explicit CountingFunction(Function* function) : Function(function->n(), {}, {}), function_(function) {}
+
+    double operator()(const Point& point) const override {
+        if (const auto it = known_.find(point); it != known_.end()) {
+            return it->second;
+        }
+        evaluations_ += 1;
+        return known_[point] = (*function_)(point);
+    }
+
+    // only the distinct unknown points of a batch are evaluated (as a batch) and counted
+    [[nodiscard]] std::vector<double> evaluate_batch(const std::vector<Point>& points) const override {
+        auto unknown = std::vector<Point>{};
+        for (const auto& point : points) {
+            if (!known_.contains(point) && ranges::find(unknown, point) == unknown.end()) {
+                unknown.push_back(point);
+            }
+        }
+        const auto values = function_->evaluate_batch(unknown);
+        evaluations_ += unknown.size();
+        for (size_t i = 0; i < unknown.size(); i++) {
+            known_[unknown[i]] = values[i];
+        }
+        auto ret = std::vector<double>(points.size());
+        for (size_t i = 0; i < points.size(); i++) {
+            ret[i] = known_.at(points[i]);
+        }
+        return ret;
+    }
+
+    // a value not below the threshold is only a bound, it isn't remembered
+    [[nodiscard]] double evaluate_bounded(const Point& point, const double threshold) const override {
+        if (const auto it = known_.find(point); it != known_.end()) {
+            return it->second;
+        }
+        evaluations_ += 1;
+        const auto value = function_->evaluate_bounded(point, threshold);
+        if (value < threshold) {
+            known_[point] = value;
+        }
+        return value;
+    }
+
+    [[nodiscard]] double evaluate_delta(const Point& point, const double value,
+                                        const size_t coordinate, const double x) const override {
+        auto moved = point;
+        moved[coordinate] = x;
+        if (const auto it = known_.find(moved); it != known_.end()) {
+            return it->second;
+        }
+        evaluations_ += 1;
+        return known_[moved] = function_->evaluate_delta(point, value, coordinate, x);
+    }
+
+    [[nodiscard]] bool has_gradient() const override { return function_->has_gradient(); }
+
+    // an exact gradient counts as an evaluation, finite differences are counted call by call
+    [[nodiscard]] std::pair<double, Point> value_and_gradient(const Point& point) const override {
+        if (!function_->has_gradient()) {
+            return Function::value_and_gradient(point);
+        }
+        evaluations_ += 1;
+        auto ret = function_->value_and_gradient(point);
+        known_[point] = ret.first;
+        return ret;
+    }
+
+    [[nodiscard]] std::vector<FunctionI::Value> minimal() const override { return function_->minimal(); }
+
+    [[nodiscard]] bool has_bounds() const override { return function_->has_bounds(); }
+
+    [[nodiscard]] Interval bounds(const Area& box) const override { return function_->bounds(box); }
+
+    [[nodiscard]] std::string name() const override { return function_->name(); }
+
+    [[nodiscard]] size_t evaluations() const { return evaluations_; }
+};
+}
+
+Function::Value NelderMead::minimal_restarting(Function* function, const Area& where, std::vector<Point>& x,
+                                               std::vector<Point>& path) const {
+    auto counting = CountingFunction(function);
+    auto* func = &counting;
+    const auto n = where.dimensions();
+    const auto stagnation = stagnation_ != 0 ? stagnation_ : 10 * n;
+
+    std::optional<Function::Value> best;
+    bool oriented = false; // the last restart was an oriented one
+    for (size_t run = 0; counting.evaluations() < budget_; run++) {
+        enum { CONVERGED, STAGNATED, DEGENERATED, EXHAUSTED } reason = CONVERGED;
+        double run_best = std::numeric_limits<double>::infinity();
+        size_t since = 0;
+        auto interrupt = [&](const std::vector<Point>& simplex) {
+            if (counting.evaluations() >= budget_) {
+                reason = EXHAUSTED;
+                return true;
+            }
+            // a step keeps the best vertex or replaces the worst one by a better point
+            const auto current = std::min((*func)(simplex.front()), (*func)(simplex.back()));
+            if (current < run_best - 1e-9 * (1 + abs(run_best))) {
+                run_best = current;
+                since = 0;
+            } else if (++since >= stagnation) {
+                reason = STAGNATED;
+                return true;
+            }
+            if (simplex_regularity(simplex) < 1e-4) {
+                reason = DEGENERATED;
+                return true;
+            }
+            return false;
+        };
+
+        const auto result = minimal_internal_(func, x, path, interrupt);
+        const auto improved = !best.has_value() || result.second < best->second;
+        if (improved) {
+            best = result;
+        }
+        if (reason == EXHAUSTED || counting.evaluations() >= budget_) {
+            break;
+        }
+
+        if (reason != CONVERGED && (!oriented || improved)) {
+            // oriented restart: a fresh right-angled simplex at the best vertex, its edges go down the simplex gradient
+            const auto& x0 = result.first;
+            const auto f0 = (*func)(x0);
+            auto others = x;
+            others.erase(ranges::find(others, x0));
+            auto diameter = 0.0;
+            auto v = Matrix(n, n);
+            auto delta = Point::rep(n, 0);
+            for (size_t i = 0; i < n; i++) {
+                const auto& vertex = others[i];
+                for (size_t j = 0; j < n; j++) {
+                    v(i, j) = vertex[j] - x0[j];
+                }
+                delta[i] = (*func)(vertex) - f0;
+                diameter = std::max(diameter, vertex.dist(x0));
+            }
+            const auto gradient = solve(v, delta);
+            x.assign(1, x0);
+            for (size_t i = 0; i < n; i++) {
+                const auto width = where.max()[i] - where.min()[i];
+                const auto step = std::max(diameter / 2, 0.05 * width);
+                const auto direction = gradient.has_value() && gradient.value()[i] > 0 ? -1.0 : 1.0;
+                auto vertex = x0;
+                vertex[i] += direction * step;
+                if (vertex[i] < where.min()[i] || vertex[i] > where.max()[i]) {
+                    vertex[i] = x0[i] - direction * step;
+                }
+                // the step may be wider than the area on both sides
+                x.push_back(where.clamped(vertex));
+            }
+            oriented = true;
+        } else {
+            x = sample(where, n + 1);
+            oriented = false;
+        }
+        const auto* why = reason == CONVERGED ? "converged" : reason == STAGNATED ? "stagnated" : "degenerated";
+        log_.counted().info(fmt::format("{} restart #{} ({}), best {} after {} evaluations",
+                                        oriented ? "oriented" : "full", run + 1, why,
+                                        best->second, counting.evaluations()));
+        for (const auto& point : x) {
+            record(path, point);
+        }
+    }
+
+    return best.value();
+}
@@ -5,6 +5,7 @@
 #include "common.h"
 #include "method.h"
 
+#include <functional>
 #include <optional>
 
 
@@ -15,6 +16,9 @@ class NelderMead final : public Method {
     double gamma_;
     double rho_;
     double sigma_;
+    size_t budget_ = 0;     // evaluations for the whole run with restarts, 0 means a single descent
+    size_t stagnation_ = 0; // steps without an improvement of the best vertex, 0 means 10 * n
+    bool adaptive_ = false; // coefficients derived from the dimensions on each run
 
     // https://en.wikipedia.org/wiki/Nelder–Mead_method
     // alpha > 0
@@ -22,7 +26,12 @@ class NelderMead final : public Method {
     // 0 < rho <= 0.5
     Function::Value minimal_internal(Function* func, std::vector<Point>& x) const;
 
-    Function::Value minimal_internal_(Function* func, std::vector<Point>& x, std::vector<Point>& path) const;
+    // `interrupt` is asked after every step, the descent stops at the current best vertex once it says so
+    Function::Value minimal_internal_(Function* func, std::vector<Point>& x, std::vector<Point>& path,
+                                      const std::function<bool(const std::vector<Point>&)>& interrupt) const;
+
+    Function::Value minimal_restarting(Function* func, const Area& where, std::vector<Point>& x,
+                                       std::vector<Point>& path) const;
 
 public:
     // If NedlerMeadMethod's (start == None) => (it's chosen randomly each run)
@@ -46,7 +55,25 @@ public:
         return *this;
     }
 
-    [[nodiscard]] std::string name() const override { return "Nelder Mead method"; }
+    // a descent which stagnates or whose simplex degenerates is restarted around its best vertex, oriented along
+    // the simplex gradient, or from a new simplex within the area if that didn't help; a converged descent
+    // is restarted within the area. Stops after `budget` evaluations, returns the best vertex seen.
+    NelderMead& with_restarts(const size_t budget, const size_t stagnation = 0) {
+        budget_ = budget;
+        stagnation_ = stagnation;
+        return *this;
+    }
+
+    // Gao & Han (2012): alpha = 1, gamma = 1 + 2/n, rho = 3/4 - 1/(2n), sigma = 1 - 1/n, which keep the expansion and
+    // the contractions from overshooting as n grows; the fixed coefficients are the same for n = 2
+    NelderMead& with_adaptive_coefficients(const bool adaptive = true) {
+        adaptive_ = adaptive;
+        return *this;
+    }
+
+    [[nodiscard]] std::string name() const override {
+        return adaptive_ ? "Nelder Mead method (adaptive)" : "Nelder Mead method";
+    }
 
     [[nodiscard]] Function::Value minimal(Function* func, const Area& where) const override {
         return minimal_with_path(func, where).second;
@@ -54,21 +81,35 @@ public:
 
     std::pair<std::vector<Point>, Function::Value>
     minimal_with_path(Function* func, const Area& where) const override {
+        if (adaptive_) {
+            const auto n = static_cast<double>(std::max<size_t>(where.dimensions(), 2));
+            auto adapted = *this;
+            adapted.adaptive_ = false;
+            adapted.alpha_ = 1;
+            adapted.gamma_ = 1 + 2 / n;
+            adapted.rho_ = 0.75 - 1 / (2 * n);
+            adapted.sigma_ = 1 - 1 / n;
+            auto ret = adapted.minimal_with_path(func, where);
+            steps_ = adapted.steps_took();
+            return ret;
+        }
+
         auto x = std::vector<Point>{};
         if (starts_.has_value()) {
             x = starts_.value();
         } else {
-            for (size_t i = 0; i <= where.dimensions(); i++) {
-                x.push_back(where.random_point());
-            }
+            x = sample(where, where.dimensions() + 1);
         }
         if (start_.has_value()) {
             x[0] = start_.value();
         }
 
         steps_ = 0;
-        auto path = std::vector<Point>{x.begin(), x.end()};
-        auto minima = minimal_internal_(func, x, path);
+        auto path = std::vector<Point>{};
+        for (const auto& point : x) {
+            record(path, point);
+        }
+        auto minima = budget_ > 0 ? minimal_restarting(func, where, x, path) : minimal_internal_(func, x, path, {});
         return {path, minima};
     }
 };
@@ -0,0 +1,202 @@
+#include "method_parallel_nelder_mead.h"
+
+#include "linalg.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <numeric>
+
+
+Function::Value ParallelNelderMead::minimal_internal(Function* func, const Area& where,
+                                                     std::vector<Point>& path) const {
+    steps_ = 0;
+    const auto n = where.dimensions();
+    const auto p = std::clamp<size_t>(parallelism_ != 0 ? parallelism_ : ThreadPool::global().size(), 1, n);
+
+    auto x = sample(where, n + 1);
+    if (start_.has_value()) {
+        x[0] = start_.value();
+    }
+    for (const auto& point : x) {
+        record(path, point);
+    }
+    auto f = func->evaluate_batch(x);
+    size_t evaluations = n + 1;
+    log_.counted().info(fmt::format("updating {} of {} vertices at once", p, n + 1));
+
+    auto order = std::vector<size_t>(n + 1);
+    while (evaluations < max_evaluations_) {
+        steps_ += 1;
+
+        // 1. Order
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::sort(order, [&](const size_t lhs, const size_t rhs) { return f[lhs] < f[rhs]; });
+        auto sorted_x = std::vector<Point>{};
+        auto sorted_f = std::vector<double>{};
+        for (const auto i : order) {
+            sorted_x.push_back(std::move(x[i]));
+            sorted_f.push_back(f[i]);
+        }
+        x = std::move(sorted_x);
+        f = std::move(sorted_f);
+        const auto prev_x = x;
+        const auto prev_f = f;
+
+        // 2. Centroid of the vertices which stay
+        const auto kept = n + 1 - p;
+        auto x_o = x[0];
+        for (size_t i = 1; i < kept; i++) {
+            x_o = x_o + x[i];
+        }
+        x_o = x_o / kept;
+        const auto best = f[0];
+        const auto kept_worst = f[kept - 1];
+
+        // 3. Reflections of the p worst vertices
+        auto reflected = std::vector<Point>(p);
+        for (size_t k = 0; k < p; k++) {
+            reflected[k] = x_o + (x_o - x[kept + k]) * alpha_;
+        }
+        const auto f_r = func->evaluate_batch(reflected);
+        evaluations += p;
+
+        // 4. Expansions and contractions of the vertices the reflection didn't settle
+        enum Move { ACCEPT, EXPAND, CONTRACT_OUTSIDE, CONTRACT_INSIDE };
+        auto moves = std::vector<Move>(p);
+        auto trials = std::vector<Point>{};
+        auto trial_of = std::vector<size_t>(p);
+        for (size_t k = 0; k < p; k++) {
+            const auto j = kept + k;
+            if (f_r[k] < best) {
+                moves[k] = EXPAND;
+                trials.push_back(x_o + (reflected[k] - x_o) * gamma_);
+            } else if (f_r[k] < kept_worst) {
+                moves[k] = ACCEPT;
+                continue;
+            } else if (f_r[k] < f[j]) {
+                moves[k] = CONTRACT_OUTSIDE;
+                trials.push_back(x_o + (reflected[k] - x_o) * rho_);
+            } else {
+                moves[k] = CONTRACT_INSIDE;
+                trials.push_back(x_o + (x[j] - x_o) * rho_);
+            }
+            trial_of[k] = trials.size() - 1;
+        }
+        const auto f_t = func->evaluate_batch(trials);
+        evaluations += trials.size();
+
+        bool improved = false;
+        for (size_t k = 0; k < p; k++) {
+            const auto j = kept + k;
+            const auto t = trial_of[k];
+            switch (moves[k]) {
+            case ACCEPT:
+                x[j] = std::move(reflected[k]);
+                f[j] = f_r[k];
+                improved = true;
+                break;
+            case EXPAND:
+                if (f_t[t] < f_r[k]) {
+                    x[j] = std::move(trials[t]);
+                    f[j] = f_t[t];
+                } else {
+                    x[j] = std::move(reflected[k]);
+                    f[j] = f_r[k];
+                }
+                improved = true;
+                break;
+            case CONTRACT_OUTSIDE:
+                if (f_t[t] <= f_r[k]) {
+                    x[j] = std::move(trials[t]);
+                    f[j] = f_t[t];
+                    improved = true;
+                }
+                break;
+            case CONTRACT_INSIDE:
+                if (f_t[t] < f[j]) {
+                    x[j] = std::move(trials[t]);
+                    f[j] = f_t[t];
+                    improved = true;
+                }
+                break;
+            }
+        }
+
+        // 5. Shrink towards the best vertex when none of the p did better
+        if (!improved) {
+            auto shrunk = std::vector<Point>{};
+            for (size_t i = 1; i <= n; i++) {
+                shrunk.push_back(x[0] + (x[i] - x[0]) * sigma_);
+            }
+            const auto f_s = func->evaluate_batch(shrunk);
+            evaluations += n;
+            for (size_t i = 1; i <= n; i++) {
+                x[i] = std::move(shrunk[i - 1]);
+                f[i] = f_s[i - 1];
+            }
+        }
+
+        // 6. Contracting several vertices towards one centroid flattens the simplex into the subspace
+        // of the others, rebuild a right-angled one at the best vertex then
+        auto best_vertex = std::ranges::min_element(f) - f.begin();
+        if (p > 1 && simplex_regularity(x) < 1e-1) {
+            auto diameter = 0.0;
+            for (const auto& vertex : x) {
+                diameter = std::max(diameter, vertex.dist(x[best_vertex]));
+            }
+            auto rebuilt = std::vector<Point>{};
+            for (size_t i = 0; i < n; i++) {
+                auto vertex = x[best_vertex];
+                vertex[i] += diameter / 2;
+                if (vertex[i] > where.max()[i]) {
+                    vertex[i] -= diameter;
+                }
+                rebuilt.push_back(std::move(vertex));
+            }
+            // a simplex this small (or lost in the rounding of x) would be rebuilt flat again on every step
+            if (diameter < tolerance_ || std::ranges::find(rebuilt, x[best_vertex]) != rebuilt.end()) {
+                log_.counted().info(fmt::format("{} < {} (simplex diameter < tolerance) after {} evaluations, "
+                                                "therefore exiting", diameter, tolerance_, evaluations));
+                break;
+            }
+            const auto f_b = func->evaluate_batch(rebuilt);
+            evaluations += n;
+            x = {x[best_vertex]};
+            f = {f[best_vertex]};
+            x.insert(x.end(), rebuilt.begin(), rebuilt.end());
+            f.insert(f.end(), f_b.begin(), f_b.end());
+            log_.counted().info(fmt::format("degenerated simplex rebuilt at {} on step #{}", x[0], steps_));
+            best_vertex = std::ranges::min_element(f) - f.begin();
+        }
+        record(path, x[best_vertex]);
+        if (f[best_vertex] < best) {
+            log_.counted().info(fmt::format("{}, func value \t{},\t on step #{}", x[best_vertex], f[best_vertex], steps_));
+        }
+
+        // the same criterion as NelderMead: the root mean square move of the vertices, values included
+        double mse = 0;
+        for (size_t i = 0; i <= n; i++) {
+            mse += sqr(x[i].appended(f[i]).dist(prev_x[i].appended(prev_f[i])));
+        }
+        mse = std::sqrt(mse / (n + 1));
+        if (mse < tolerance_) {
+            log_.counted().info(fmt::format("{} < {} (MSE < tolerance) after {} evaluations, therefore exiting",
+                                            mse, tolerance_, evaluations));
+            break;
+        }
+    }
+
+    const auto best_vertex = std::ranges::min_element(f) - f.begin();
+    return {x[best_vertex], f[best_vertex]};
+}
+
+std::pair<std::vector<Point>, Function::Value>
+ParallelNelderMead::minimal_with_path(Function* func, const Area& where) const {
+    std::vector<Point> path;
+    auto ret = minimal_internal(func, where, path);
+    return {path, ret};
+}
+
+Function::Value ParallelNelderMead::minimal(Function* func, const Area& where) const {
+    return minimal_with_path(func, where).second;
+}
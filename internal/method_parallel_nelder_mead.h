@@ -0,0 +1,47 @@
+#ifndef PARALLEL_NELDER_MEAD_H
+#define PARALLEL_NELDER_MEAD_H
+
+#include <utility>
+
+#include "common.h"
+#include "log.h"
+#include "method.h"
+
+
+// Parallel Nelder-Mead (Lee & Wiswall, 2007): every step reflects, expands or contracts the p worst vertices
+// against the centroid of the other n + 1 - p ones, the simplex shrinks only when none of them improved.
+// The reflections are one parallel batch, the expansions and contractions of all p vertices are another,
+// so a step costs about two evaluations of wall-clock time; with p == 1 it's the usual Nelder-Mead.
+// Vertex values are kept, nothing is evaluated twice.
+class ParallelNelderMead final : public Method {
+    double tolerance_;
+    size_t parallelism_;
+    size_t max_evaluations_;
+    double alpha_;
+    double gamma_;
+    double rho_;
+    double sigma_;
+
+public:
+    // parallelism -- vertices updated at once, 0 means the threads of ThreadPool::global(), at most n are used
+    explicit ParallelNelderMead(const Log& logger, const double tolerance = 0.01, const size_t parallelism = 0,
+                                const size_t max_evaluations = 100000, const double alpha = 1,
+                                const double gamma = 2, const double rho = 0.5, const double sigma = 0.5)
+        : Method(logger.with("ParallelNelderMead")),
+          tolerance_(tolerance), parallelism_(parallelism), max_evaluations_(max_evaluations),
+          alpha_(alpha), gamma_(gamma), rho_(rho), sigma_(sigma) {}
+
+    [[nodiscard]]
+    std::string name() const override { return "Parallel Nelder Mead method"; }
+
+    Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
+
+    [[nodiscard]]
+    Function::Value minimal(Function* func, const Area& where) const override;
+
+    [[nodiscard]]
+    std::pair<std::vector<Point>, Function::Value>
+    minimal_with_path(Function* func, const Area& where) const override;
+};
+
+#endif //PARALLEL_NELDER_MEAD_H
@@ -0,0 +1,104 @@
+#include "method_particle_swarm.h"
+
+#include "population.h"
+#include "random.h"
+
+#include <algorithm>
+
+
+Function::Value ParticleSwarm::minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const {
+    steps_ = 0;
+    const auto n = where.dimensions();
+    const auto size = size_ != 0 ? size_ : std::max<size_t>(20, 10 + static_cast<size_t>(2 * std::sqrt(n)));
+
+    auto position = sampler_ ? Population::sample(size, where, *sampler_) : Population::random(size, where);
+    if (start_.has_value()) {
+        const auto start = where.clamped(start_.value());
+        for (size_t d = 0; d < n; d++) {
+            position.coordinate(d)[0] = start[d];
+        }
+    }
+
+    // velocities start as a random fraction of the area and are limited by a fifth of it
+    auto velocity = Population(size, n);
+    auto limit = std::vector<double>(n);
+    for (size_t d = 0; d < n; d++) {
+        limit[d] = (where.max()[d] - where.min()[d]) / 5;
+        auto* v = velocity.coordinate(d);
+        for (size_t i = 0; i < size; i++) {
+            v[i] = random::gen(-limit[d], limit[d]);
+        }
+    }
+
+    auto personal = position;
+    auto personal_values = position.evaluate(*func);
+    auto best = static_cast<size_t>(std::ranges::min_element(personal_values) - personal_values.begin());
+    auto best_point = personal.point(best);
+    auto best_value = personal_values[best];
+    record(path, best_point);
+
+    auto r1 = std::vector<double>(size), r2 = std::vector<double>(size);
+    for (size_t iter = 1; iter <= max_; iter++) {
+        steps_ += 1;
+
+        // 1. Move, coordinate by coordinate over the whole swarm
+        for (size_t d = 0; d < n; d++) {
+            for (size_t i = 0; i < size; i++) {
+                r1[i] = random::gen(0, 1);
+                r2[i] = random::gen(0, 1);
+            }
+            auto* x = position.coordinate(d);
+            auto* v = velocity.coordinate(d);
+            const auto* p = personal.coordinate(d);
+            const auto g = best_point[d];
+            const auto lo = where.min()[d], hi = where.max()[d];
+            for (size_t i = 0; i < size; i++) {
+                v[i] = inertia_ * v[i] + cognitive_ * r1[i] * (p[i] - x[i]) + social_ * r2[i] * (g - x[i]);
+                v[i] = std::clamp(v[i], -limit[d], limit[d]);
+                x[i] = x[i] + v[i];
+                // particles stop at the walls
+                if (x[i] < lo || x[i] > hi) {
+                    x[i] = std::clamp(x[i], lo, hi);
+                    v[i] = 0;
+                }
+            }
+        }
+
+        // 2. Evaluate and update the memories
+        const auto values = position.evaluate(*func);
+        for (size_t i = 0; i < size; i++) {
+            if (values[i] < personal_values[i]) {
+                personal.assign(i, position, i);
+                personal_values[i] = values[i];
+            }
+        }
+
+        if (const auto current = static_cast<size_t>(
+                std::ranges::min_element(personal_values) - personal_values.begin());
+            personal_values[current] < best_value) {
+            best_point = personal.point(current);
+            best_value = personal_values[current];
+            record(path, best_point);
+            log_.counted().info(fmt::format("{}, func value \t{},\t on iteration #{}", best_point, best_value, iter));
+        }
+
+        if (const auto [lo, hi] = std::ranges::minmax(personal_values); hi - lo < tolerance_) {
+            log_.counted().info(fmt::format("EXITING: personal bests range < {}, on iteration #{}",
+                                            tolerance_, iter));
+            break;
+        }
+    }
+
+    return {best_point, best_value};
+}
+
+std::pair<std::vector<Point>, Function::Value> ParticleSwarm::minimal_with_path(Function* func,
+                                                                               const Area& where) const {
+    std::vector<Point> path;
+    auto ret = minimal_internal(func, where, path);
+    return {path, ret};
+}
+
+Function::Value ParticleSwarm::minimal(Function* func, const Area& where) const {
+    return minimal_with_path(func, where).second;
+}
@@ -0,0 +1,44 @@
+#ifndef PARTICLE_SWARM_H
+#define PARTICLE_SWARM_H
+
+#include <utility>
+
+#include "common.h"
+#include "log.h"
+#include "method.h"
+
+
+// https://en.wikipedia.org/wiki/Particle_swarm_optimization, global best topology with the
+// constriction coefficients of Clerc & Kennedy as defaults.
+// Positions, velocities and personal bests are kept as structures of arrays (see Population),
+// every iteration is one parallel batch.
+class ParticleSwarm final : public Method {
+    size_t size_;
+    double inertia_;
+    double cognitive_;
+    double social_;
+    double tolerance_;
+    size_t max_;
+
+public:
+    // size == 0 -- 10 + 2 sqrt(n) particles (at least 20)
+    explicit ParticleSwarm(const Log& logger, const size_t size = 0, const double inertia = 0.7298,
+                           const double cognitive = 1.49618, const double social = 1.49618,
+                           const double tolerance = 1e-8, const size_t max = 1000)
+        : Method(logger.with("ParticleSwarm")),
+          size_(size), inertia_(inertia), cognitive_(cognitive), social_(social), tolerance_(tolerance), max_(max) {}
+
+    [[nodiscard]]
+    std::string name() const override { return "Particle Swarm method"; }
+
+    Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
+
+    [[nodiscard]]
+    Function::Value minimal(Function* func, const Area& where) const override;
+
+    [[nodiscard]]
+    std::pair<std::vector<Point>, Function::Value>
+    minimal_with_path(Function* func, const Area& where) const override;
+};
+
+#endif //PARTICLE_SWARM_H
@@ -0,0 +1,86 @@
+#include "method_pattern_search.h"
+
+#include <algorithm>
+#include <numeric>
+
+
+Function::Value PatternSearch::minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const {
+    steps_ = 0;
+    const auto n = where.dimensions();
+
+    auto x = start_.has_value() ? where.clamped(start_.value()) : sample(where, 1).front();
+    auto value = (*func)(x);
+    size_t evaluations = 1;
+    record(path, x);
+
+    // directions 2i and 2i + 1 are +e_i and -e_i, in polling order
+    auto order = std::vector<size_t>(2 * n);
+    std::iota(order.begin(), order.end(), 0);
+    auto mesh = step_;
+    auto move = Point::rep(n, 0); // the last successful move, 0 after a failure
+    bool moved = false;
+
+    while (mesh >= tolerance_ && evaluations < max_evaluations_) {
+        steps_ += 1;
+
+        // 1. The pattern point and the poll points, the ones clamped onto x are left out
+        auto candidates = std::vector<Point>{};
+        auto directions = std::vector<size_t>{}; // 2n for the pattern point
+        if (moved) {
+            candidates.push_back(where.clamped(x + move));
+            directions.push_back(2 * n);
+        }
+        for (const auto d : order) {
+            auto candidate = x;
+            const auto i = d / 2;
+            candidate[i] += (d % 2 == 0 ? 1 : -1) * mesh * (where.max()[i] - where.min()[i]);
+            candidate = where.clamped(candidate);
+            if (candidate[i] != x[i]) {
+                candidates.push_back(std::move(candidate));
+                directions.push_back(d);
+            }
+        }
+        if (candidates.empty()) {
+            break;
+        }
+
+        // 2. Poll them at once, take the first improvement
+        const auto values = func->evaluate_batch(candidates);
+        evaluations += candidates.size();
+        const auto first = std::ranges::find_if(values, [value](const double v) { return v < value; });
+        if (first == values.end()) {
+            mesh *= contraction_;
+            moved = false;
+            log_.counted().debug(fmt::format("no improvement, mesh {}", mesh));
+            continue;
+        }
+
+        const auto k = static_cast<size_t>(first - values.begin());
+        move = candidates[k] - x;
+        x = candidates[k];
+        value = values[k];
+        moved = true;
+        mesh *= expansion_;
+        if (directions[k] != 2 * n) {
+            // the successful direction is polled first next time
+            std::ranges::rotate(order.begin(), std::ranges::find(order, directions[k]),
+                                std::ranges::find(order, directions[k]) + 1);
+        }
+        record(path, x);
+        log_.counted().info(fmt::format("{}, func value \t{},\t on step #{}, mesh {}", x, value, steps_, mesh));
+    }
+
+    log_.counted().info(fmt::format("exiting after {} evaluations, mesh {}", evaluations, mesh));
+    return {x, value};
+}
+
+std::pair<std::vector<Point>, Function::Value>
+PatternSearch::minimal_with_path(Function* func, const Area& where) const {
+    std::vector<Point> path;
+    auto ret = minimal_internal(func, where, path);
+    return {path, ret};
+}
+
+Function::Value PatternSearch::minimal(Function* func, const Area& where) const {
+    return minimal_with_path(func, where).second;
+}
@@ -0,0 +1,44 @@
+#ifndef PATTERN_SEARCH_H
+#define PATTERN_SEARCH_H
+
+#include <utility>
+
+#include "common.h"
+#include "log.h"
+#include "method.h"
+
+
+// PatternSearch: Hooke-Jeeves / generalized pattern search, https://en.wikipedia.org/wiki/Pattern_search_(optimization).
+// Every step polls the 2n points one mesh step along the coordinates, after a success preceded by the pattern
+// point (the last move repeated), all of them as one parallel batch. The first improving point in the polling
+// order is taken (opportunistic polling) and its direction is polled first from then on; the mesh grows
+// after a success and shrinks after a failure. Poll points are clamped into the Area.
+class PatternSearch final : public Method {
+    double tolerance_;
+    size_t max_evaluations_;
+    double step_;
+    double expansion_;
+    double contraction_;
+
+public:
+    // step -- the initial mesh size, as a fraction of every side of the area; it's also the unit of the tolerance
+    explicit PatternSearch(const Log& logger, const double tolerance = 1e-8, const size_t max_evaluations = 100000,
+                           const double step = 0.1, const double expansion = 2, const double contraction = 0.5)
+        : Method(logger.with("PatternSearch")),
+          tolerance_(tolerance), max_evaluations_(max_evaluations),
+          step_(step), expansion_(expansion), contraction_(contraction) {}
+
+    [[nodiscard]]
+    std::string name() const override { return "Pattern Search method"; }
+
+    Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
+
+    [[nodiscard]]
+    Function::Value minimal(Function* func, const Area& where) const override;
+
+    [[nodiscard]]
+    std::pair<std::vector<Point>, Function::Value>
+    minimal_with_path(Function* func, const Area& where) const override;
+};
+
+#endif //PATTERN_SEARCH_H
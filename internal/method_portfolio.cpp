@@ -0,0 +1,254 @@
+#include "method_portfolio.h"
+#include "random.h"
+
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+
+namespace {
+// shared by the racing methods
+struct Race {
+    std::atomic<double> incumbent{std::numeric_limits<double>::infinity()};
+    std::atomic<size_t> incumbent_at{0}; // evaluations the leader needed for it, may lag the value a bit
+    std::atomic<bool> stop{false};
+};
+
+// thrown out of a method once another one has reached the target
+class Stopped final : public std::exception {};
+
+// thrown out of a method which has fallen hopelessly behind
+class Abandoned final : public std::exception {};
+
+// counts the evaluations of one method, keeps its best point and the trail of its improvements,
+// publishes the improvements to the race
+class RacingFunction final : public Function {
+    Function* function_;
+    Race* race_;
+    std::optional<double> target_;
+    double patience_;
+    size_t grace_;
+    mutable std::mutex mutex_;
+    mutable std::atomic<size_t> evaluations_{0};
+    mutable Function::Value best_{{}, std::numeric_limits<double>::infinity()};
+    mutable size_t best_at_ = 0;
+    mutable size_t reached_at_ = 0;
+    mutable std::vector<Point> trail_;
+
+    // charges `count` evaluations and returns the number of the last one, unless the method is out of the race
+    size_t charge(const size_t count) const {
+        if (race_->stop.load(std::memory_order_relaxed)) {
+            throw Stopped{};
+        }
+        const auto evaluation = evaluations_.fetch_add(count, std::memory_order_relaxed) + count;
+        if (evaluation > grace_) {
+            const auto incumbent = race_->incumbent.load(std::memory_order_relaxed);
+            const auto needed = static_cast<double>(race_->incumbent_at.load(std::memory_order_relaxed));
+            if (static_cast<double>(evaluation) > patience_ * needed && best().second > incumbent) {
+                throw Abandoned{};
+            }
+        }
+        return evaluation;
+    }
+
+    // keeps and publishes the exact value the evaluation found
+    void report(const Point& point, const double value, const size_t evaluation) const {
+        {
+            const auto lock = std::lock_guard(mutex_);
+            if (value < best_.second) {
+                best_ = {point, value};
+                best_at_ = evaluation;
+                trail_.push_back(point);
+                if (target_.has_value() && value <= target_.value() && reached_at_ == 0) {
+                    reached_at_ = evaluation;
+                }
+            }
+        }
+        auto incumbent = race_->incumbent.load(std::memory_order_relaxed);
+        while (value < incumbent) {
+            if (race_->incumbent.compare_exchange_weak(incumbent, value, std::memory_order_relaxed)) {
+                race_->incumbent_at.store(evaluation, std::memory_order_relaxed);
+                break;
+            }
+        }
+        if (target_.has_value() && value <= target_.value()) {
+            race_->stop.store(true, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    RacingFunction(Function* function, Race* race, const std::optional<double> target,
+                   const double patience, const size_t grace)
+        : Function(function->n(), {}, {}),
+          function_(function), race_(race), target_(target), patience_(patience), grace_(grace) {}
+
+    double operator()(const Point& point) const override {
+        const auto evaluation = charge(1);
+        const auto value = (*function_)(point);
+        report(point, value, evaluation);
+        return value;
+    }
+
+    // a batch costs an evaluation per point
+    [[nodiscard]] std::vector<double> evaluate_batch(const std::vector<Point>& points) const override {
+        const auto last = charge(points.size());
+        const auto values = function_->evaluate_batch(points);
+        for (size_t i = 0; i < points.size(); i++) {
+            report(points[i], values[i], last - points.size() + i + 1);
+        }
+        return values;
+    }
+
+    // a value not below the threshold is only a bound, it isn't kept
+    [[nodiscard]] double evaluate_bounded(const Point& point, const double threshold) const override {
+        const auto evaluation = charge(1);
+        const auto value = function_->evaluate_bounded(point, threshold);
+        if (value < threshold) {
+            report(point, value, evaluation);
+        }
+        return value;
+    }
+
+    [[nodiscard]] double evaluate_delta(const Point& point, const double value,
+                                        const size_t coordinate, const double x) const override {
+        const auto evaluation = charge(1);
+        const auto ret = function_->evaluate_delta(point, value, coordinate, x);
+        auto moved = point;
+        moved[coordinate] = x;
+        report(moved, ret, evaluation);
+        return ret;
+    }
+
+    [[nodiscard]] bool has_gradient() const override { return function_->has_gradient(); }
+
+    // an exact gradient costs an evaluation, finite differences are charged call by call
+    [[nodiscard]] std::pair<double, Point> value_and_gradient(const Point& point) const override {
+        if (!function_->has_gradient()) {
+            return Function::value_and_gradient(point);
+        }
+        const auto evaluation = charge(1);
+        auto ret = function_->value_and_gradient(point);
+        report(point, ret.first, evaluation);
+        return ret;
+    }
+
+    [[nodiscard]] std::vector<FunctionI::Value> minimal() const override { return function_->minimal(); }
+
+    [[nodiscard]] std::vector<FunctionI::Value> maximum() const override { return function_->maximum(); }
+
+    [[nodiscard]] bool has_bounds() const override { return function_->has_bounds(); }
+
+    [[nodiscard]] Interval bounds(const Area& box) const override { return function_->bounds(box); }
+
+    [[nodiscard]] bool is_dimensions_supported(const size_t n) const override {
+        return function_->is_dimensions_supported(n);
+    }
+
+    [[nodiscard]] std::string name() const override { return function_->name(); }
+
+    [[nodiscard]] size_t evaluations() const { return evaluations_.load(); }
+
+    [[nodiscard]] Function::Value best() const {
+        const auto lock = std::lock_guard(mutex_);
+        return best_;
+    }
+
+    [[nodiscard]] size_t best_at() const { return best_at_; }
+
+    [[nodiscard]] size_t reached_at() const { return reached_at_; }
+
+    [[nodiscard]] const std::vector<Point>& trail() const { return trail_; }
+};
+}
+
+Function::Value Portfolio::minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const {
+    if (methods_.empty()) {
+        throw std::invalid_argument("Portfolio needs at least one method");
+    }
+    using Status = Outcome::Status;
+
+    auto race = Race{};
+    auto functions = std::vector<std::unique_ptr<RacingFunction>>{};
+    outcomes_.assign(methods_.size(), Outcome{});
+    auto errors = std::vector<std::exception_ptr>(methods_.size());
+    auto threads = std::vector<std::thread>{};
+    for (size_t k = 0; k < methods_.size(); k++) {
+        functions.push_back(std::make_unique<RacingFunction>(func, &race, target_, patience_, grace_));
+        if (start_.has_value()) {
+            methods_[k]->with_start(start_.value());
+        }
+        outcomes_[k].method = methods_[k]->name();
+    }
+    // every method draws from its own engine seeded here, so the race is free of data races and a seed
+    // still reproduces each method's draws
+    auto engines = std::vector<std::mt19937_64>{};
+    for (size_t k = 0; k < methods_.size(); k++) {
+        engines.emplace_back(random::engine()());
+    }
+    for (size_t k = 0; k < methods_.size(); k++) {
+        threads.emplace_back([&, k] {
+            random::with_engine(&engines[k]);
+            try {
+                static_cast<void>(methods_[k]->minimal(functions[k].get(), where));
+                outcomes_[k].status = Status::FINISHED;
+            } catch (const Stopped&) {
+                outcomes_[k].status = Status::STOPPED;
+            } catch (const Abandoned&) {
+                outcomes_[k].status = Status::ABANDONED;
+            } catch (...) {
+                errors[k] = std::current_exception();
+                race.stop.store(true);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    winner_ = 0;
+    for (size_t k = 0; k < methods_.size(); k++) {
+        auto& outcome = outcomes_[k];
+        outcome.best = functions[k]->best();
+        outcome.best_at = functions[k]->best_at();
+        outcome.reached_at = functions[k]->reached_at();
+        outcome.evaluations = functions[k]->evaluations();
+        if (outcome.reached_at != 0) {
+            outcome.status = Status::REACHED_TARGET;
+        }
+        log_.counted().info(fmt::format("{}: func value \t{},\t found on evaluation #{} of {}",
+                                        outcome.method, outcome.best.second, outcome.best_at, outcome.evaluations));
+        const auto& leader = outcomes_[winner_];
+        if (outcome.reached_at != 0 || leader.reached_at != 0) {
+            if (outcome.reached_at != 0 && (leader.reached_at == 0 || outcome.reached_at < leader.reached_at)) {
+                winner_ = k;
+            }
+        } else if (outcome.best.second < leader.best.second
+                   || (outcome.best.second == leader.best.second && outcome.best_at < leader.best_at)) {
+            winner_ = k;
+        }
+    }
+
+    steps_ = methods_[winner_]->steps_took();
+    for (const auto& point : functions[winner_]->trail()) {
+        record(path, point);
+    }
+    return outcomes_[winner_].best;
+}
+
+std::pair<std::vector<Point>, Function::Value> Portfolio::minimal_with_path(Function* func, const Area& where) const {
+    std::vector<Point> path;
+    auto ret = minimal_internal(func, where, path);
+    return {path, ret};
+}
+
+Function::Value Portfolio::minimal(Function* func, const Area& where) const {
+    return minimal_with_path(func, where).second;
+}
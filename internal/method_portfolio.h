@@ -0,0 +1,78 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "common.h"
+#include "log.h"
+#include "method.h"
+
+
+// Portfolio: races several methods on the same function, each on its own thread. They share the best value
+// found so far (a lock-free atomic), all of them stop once one reaches the target, and a method is abandoned
+// when it has spent `patience` times the evaluations the leader needed for a better value than its own.
+// The winner is the method which reached the target in the fewest of its evaluations, or the one with the lowest
+// value without a target (or when none reached it). outcomes() tells how each method did.
+// The start point is passed on to the methods, the samplers aren't: a sampler isn't thread safe,
+// every method keeps its own.
+class Portfolio final : public Method {
+public:
+    struct Outcome {
+        enum class Status { FINISHED, REACHED_TARGET, STOPPED, ABANDONED };
+
+        std::string method;
+        Function::Value best;
+        size_t best_at = 0;     // the evaluation which found the best point
+        size_t reached_at = 0;  // the evaluation which reached the target, 0 if none did
+        size_t evaluations = 0; // all the evaluations the method has done
+        Status status = Status::FINISHED;
+
+        [[nodiscard]] std::string_view status_name() const {
+            switch (status) {
+            case Status::FINISHED: return "finished";
+            case Status::REACHED_TARGET: return "reached the target";
+            case Status::STOPPED: return "stopped, the target was reached";
+            case Status::ABANDONED: return "abandoned, hopelessly behind";
+            }
+            return "?";
+        }
+    };
+
+private:
+    std::vector<std::shared_ptr<Method>> methods_;
+    std::optional<double> target_;
+    double patience_;
+    size_t grace_;
+    mutable std::vector<Outcome> outcomes_;
+    mutable size_t winner_ = 0;
+
+public:
+    // grace -- evaluations every method may do before it can be abandoned
+    explicit Portfolio(const Log& logger, std::vector<std::shared_ptr<Method>> methods,
+                       const std::optional<double> target = {}, const double patience = 4, const size_t grace = 1000)
+        : Method(logger.with("Portfolio")),
+          methods_(std::move(methods)), target_(target), patience_(patience), grace_(grace) {}
+
+    [[nodiscard]]
+    std::string name() const override { return fmt::format("Portfolio of {} methods", methods_.size()); }
+
+    // how each method did in the last run, in the order they were given
+    [[nodiscard]] const std::vector<Outcome>& outcomes() const { return outcomes_; }
+
+    // index of the method which found the result of the last run
+    [[nodiscard]] size_t winner() const { return winner_; }
+
+    Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
+
+    [[nodiscard]]
+    Function::Value minimal(Function* func, const Area& where) const override;
+
+    [[nodiscard]]
+    std::pair<std::vector<Point>, Function::Value>
+    minimal_with_path(Function* func, const Area& where) const override;
+};
+
+#endif //PORTFOLIO_H
@@ -2,15 +2,45 @@
 
 #include "random.h"
 
+#include <algorithm>
 #include <optional>
 
 
+namespace {
+// points of the global jumps, generated in bulk by the sampler when there is one
+class GlobalPoints {
+    const Area& where_;
+    Sampler* sampler_;
+    std::vector<Point> points_;
+
+public:
+    GlobalPoints(const Area& where, Sampler* sampler) : where_(where), sampler_(sampler) {}
+
+    Point next() {
+        if (sampler_ == nullptr) {
+            return where_.random_point();
+        }
+        if (points_.empty()) {
+            points_ = where_.sample(*sampler_, 64);
+            std::ranges::reverse(points_);
+        }
+        auto ret = std::move(points_.back());
+        points_.pop_back();
+        return ret;
+    }
+};
+}
+
 Function::Value RandomWalk::minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const {
+    if (coordinate_wise_) {
+        return minimal_coordinate_wise(func, where, path);
+    }
     steps_ = 0;
+    auto globals = GlobalPoints(where, sampler_.get());
     std::optional<Function::Value> min;
     if (start_.has_value()) {
         min = {start_.value(), (*func)(start_.value())};
-        path.push_back(start_.value());
+        record(path, start_.value());
     }
     for (size_t iter = 1; iter < max_; iter++) {
         steps_ += 1;
@@ -18,11 +48,12 @@ Function::Value RandomWalk::minimal_internal(Function* func, const Area& where,
         if (min.has_value() && random::with_chance(p_)) {
             point = min.value().first.uniformly_deviate(-delta_, delta_);
         } else {
-            point = where.random_point();
+            point = globals.next();
         }
-        const auto value = (*func)(point);
+        // a candidate losing by the tolerance is neither taken nor stops the walk, its exact value doesn't matter
+        const auto value = min.has_value() ? func->evaluate_bounded(point, min->second + tolerance_) : (*func)(point);
         if (!min.has_value()) {
-            path.push_back(point);
+            record(path, point);
             min = {std::move(point), value};
             log_.counted().info(fmt::format("{}, func value \t{},\t on iteration #{}",
                                             min->first, min->second, iter));
@@ -30,14 +61,14 @@ Function::Value RandomWalk::minimal_internal(Function* func, const Area& where,
         }
 
         if (abs(min.value().second - value) < tolerance_ && min_ <= iter) {
-            path.push_back(point);
+            record(path, point);
             log_.counted().info(fmt::format("EXITING: (|x_0 - x_n| < tolerance),\t on iteration #{}",
                                             min->first, min->second, iter));
             return min.value();
         }
 
         if (value < min.value().second) {
-            path.push_back(point);
+            record(path, point);
             min = {point, value};
             log_.counted().info(fmt::format("{}, func value \t{},\t on iteration #{}", min->first,
                                             min->second, iter));
@@ -48,6 +79,73 @@ Function::Value RandomWalk::minimal_internal(Function* func, const Area& where,
     return min.value();
 }
 
+Function::Value RandomWalk::minimal_coordinate_wise(Function* func, const Area& where,
+                                                   std::vector<Point>& path) const {
+    steps_ = 0;
+    const auto n = where.dimensions();
+    // the path gets every accepted move in low dimensions, and a few points per n of them in high ones
+    const auto record_every = std::max<size_t>(1, n / 16);
+    auto coordinate = std::uniform_int_distribution<size_t>(0, n - 1);
+    size_t accepted = 0;
+    auto globals = GlobalPoints(where, sampler_.get());
+
+    std::optional<Function::Value> min;
+    if (start_.has_value()) {
+        min = {start_.value(), (*func)(start_.value())};
+        record(path, start_.value());
+    }
+    for (size_t iter = 1; iter < max_; iter++) {
+        steps_ += 1;
+        if (!min.has_value() || !random::with_chance(p_)) {
+            auto point = globals.next();
+            const auto value = min.has_value() ? func->evaluate_bounded(point, min->second + tolerance_)
+                                               : (*func)(point);
+            if (min.has_value() && abs(min->second - value) < tolerance_ && min_ <= iter) {
+                record(path, point);
+                log_.counted().info(fmt::format("EXITING: (|x_0 - x_n| < tolerance),\t on iteration #{}", iter));
+                return min.value();
+            }
+            if (!min.has_value() || value < min->second) {
+                record(path, point);
+                min = {std::move(point), value};
+                log_.counted().info(fmt::format("{}, func value \t{},\t on iteration #{}",
+                                                min->first, min->second, iter));
+            }
+            continue;
+        }
+
+        auto& [best, best_value] = min.value();
+        const auto i = coordinate(random::engine());
+        const auto x = best[i] + random::gen(-delta_, delta_);
+        const auto value = func->evaluate_delta(best, best_value, i, x);
+
+        if (abs(best_value - value) < tolerance_ && min_ <= iter) {
+            auto point = best;
+            point[i] = x;
+            record(path, point);
+            log_.counted().info(fmt::format("EXITING: (|x_0 - x_n| < tolerance),\t on iteration #{}", iter));
+            return min.value();
+        }
+
+        if (value < best_value) {
+            best[i] = x;
+            best_value = value;
+            accepted += 1;
+            // the updates accumulate rounding errors, so the value is refreshed once per n moves
+            if (accepted % n == 0) {
+                best_value = (*func)(best);
+            }
+            if (accepted % record_every == 0) {
+                record(path, best);
+                log_.counted().debug(fmt::format("func value \t{},\t on iteration #{}", best_value, iter));
+            }
+        }
+    }
+
+    log_.counted().info(fmt::format("EXITING: iterations maximum has been reached"));
+    return min.value();
+}
+
 std::pair<std::vector<Point>, Function::Value> RandomWalk::minimal_with_path(Function* func, const Area& where) const {
     std::vector<Point> path;
     auto ret = minimal_internal(func, where, path);
@@ -14,16 +14,24 @@ class RandomWalk final : public Method {
     double tolerance_;
     const double delta_;
     const double p_;
+    const bool coordinate_wise_;
+
+    Function::Value minimal_coordinate_wise(Function* func, const Area& where, std::vector<Point>& path) const;
 
 public:
+    // coordinate_wise: a local move deviates a single random coordinate instead of all of them,
+    // its value is updated by Function::evaluate_delta, which is O(1) for separable functions
     explicit RandomWalk(const Log& logger, const double delta = 0.1, const double p = 0.2,
-                        const double tolerance = 1e-5, const size_t min = 100, const size_t max = 10000)
+                        const double tolerance = 1e-5, const size_t min = 100, const size_t max = 10000,
+                        const bool coordinate_wise = false)
         : Method(logger.with("RandomWalk")),
           min_(min), max_(max), tolerance_(tolerance),
-          delta_(delta), p_(p) {}
+          delta_(delta), p_(p), coordinate_wise_(coordinate_wise) {}
 
     [[nodiscard]]
-    std::string name() const override { return "Random Walk method"; }
+    std::string name() const override {
+        return coordinate_wise_ ? "Random Walk method (coordinate-wise)" : "Random Walk method";
+    }
 
     Function::Value minimal_internal(Function* func, const Area& where, std::vector<Point>& path) const;
     [[nodiscard]]
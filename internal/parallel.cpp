@@ -0,0 +1,108 @@
+#include "parallel.h"
+
+#include <algorithm>
+
+
+// set on the pool's workers and on a caller for the duration of its loop, their nested loops run inline
+static thread_local bool in_loop = false;
+
+ThreadPool::ThreadPool(const size_t threads) {
+    for (size_t i = 1; i < threads; i++) {
+        workers_.emplace_back([this] { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+void ThreadPool::run_chunks() {
+    for (auto begin = next_.fetch_add(grain_); begin < n_; begin = next_.fetch_add(grain_)) {
+        try {
+            (*job_)(begin, std::min(begin + grain_, n_));
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            next_ = n_; // nobody takes new chunks
+        }
+    }
+}
+
+void ThreadPool::work() {
+    in_loop = true;
+    size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        run_chunks();
+
+        {
+            std::lock_guard lock(mutex_);
+            active_ -= 1;
+        }
+        done_.notify_one();
+    }
+}
+
+void ThreadPool::parallel_for(const size_t n, const size_t grain,
+                              const std::function<void(size_t begin, size_t end)>& func) {
+    if (n == 0) {
+        return;
+    }
+
+    std::unique_lock job_lock(job_mutex_, std::defer_lock);
+    if (workers_.empty() || n <= grain || in_loop || !job_lock.try_lock()) {
+        func(0, n);
+        return;
+    }
+    in_loop = true;
+    struct Reset {
+        ~Reset() { in_loop = false; }
+    } reset;
+
+    {
+        std::lock_guard lock(mutex_);
+        job_ = &func;
+        n_ = n;
+        grain_ = std::max<size_t>(1, grain);
+        next_ = 0;
+        error_ = nullptr;
+        active_ = workers_.size();
+        generation_ += 1;
+    }
+    wake_.notify_all();
+
+    run_chunks();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [&] { return active_ == 0; });
+        job_ = nullptr;
+        error = error_;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// ThreadPool: a fixed set of workers for data-parallel loops, the calling thread works too.
+// Only one loop runs on the pool at a time, nested or concurrent calls are executed inline by the caller,
+// so it's always safe (if not always parallel) to call parallel_for from anywhere.
+class ThreadPool {
+    std::vector<std::thread> workers_;
+    std::mutex job_mutex_; // held by the caller for the whole loop
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    size_t generation_ = 0;
+    size_t active_ = 0;
+    bool stop_ = false;
+
+    const std::function<void(size_t, size_t)>* job_ = nullptr;
+    size_t n_ = 0, grain_ = 1;
+    std::atomic<size_t> next_{0};
+    std::exception_ptr error_;
+
+    void run_chunks();
+
+    void work();
+
+public:
+    explicit ThreadPool(size_t threads);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // std::thread::hardware_concurrency() threads, including the caller
+    static ThreadPool& global();
+
+    // number of threads working on a loop, including the caller
+    [[nodiscard]] size_t size() const {
+        return workers_.size() + 1;
+    }
+
+    // calls func(begin, end) for chunks of [0, n) of (at least) `grain` indexes each, returns when all are done.
+    // The first exception thrown by func is rethrown here.
+    void parallel_for(size_t n, size_t grain, const std::function<void(size_t begin, size_t end)>& func);
+
+    // grain splitting n into a few chunks per thread
+    [[nodiscard]] size_t grain_for(const size_t n) const {
+        return std::max<size_t>(1, n / (4 * size()));
+    }
+};
+
+
+#endif //PARALLEL_H
@@ -0,0 +1,92 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include "common.h"
+#include "function.h"
+
+#include <vector>
+
+
+// Population: points of a population-based method stored as a structure of arrays,
+// data_[d * size_ + i] is the d-th coordinate of the i-th individual.
+// Per-coordinate loops over the whole population run over contiguous memory and vectorize.
+class Population {
+    size_t size_, dimensions_;
+    std::vector<double> data_;
+
+public:
+    Population(const size_t size, const size_t dimensions)
+        : size_(size), dimensions_(dimensions), data_(size * dimensions) {}
+
+    // uniformly random individuals within the area
+    static Population random(const size_t size, const Area& where) {
+        auto ret = Population(size, where.dimensions());
+        for (size_t d = 0; d < ret.dimensions_; d++) {
+            auto* row = ret.coordinate(d);
+            for (size_t i = 0; i < size; i++) {
+                row[i] = random::gen(where.min()[d], where.max()[d]);
+            }
+        }
+        return ret;
+    }
+
+    // individuals from the sampler, mapped onto the area
+    static Population sample(const size_t size, const Area& where, Sampler& sampler) {
+        auto ret = Population(size, where.dimensions());
+        auto unit = std::vector<double>(size * ret.dimensions_);
+        sampler.generate(size, ret.dimensions_, unit.data());
+        for (size_t d = 0; d < ret.dimensions_; d++) {
+            auto* row = ret.coordinate(d);
+            for (size_t i = 0; i < size; i++) {
+                row[i] = where.percentile(d, unit[i * ret.dimensions_ + d]);
+            }
+        }
+        return ret;
+    }
+
+    [[nodiscard]] size_t size() const { return size_; }
+
+    [[nodiscard]] size_t dimensions() const { return dimensions_; }
+
+    // d-th coordinate of all the individuals
+    double* coordinate(const size_t d) { return &data_[d * size_]; }
+
+    [[nodiscard]] const double* coordinate(const size_t d) const { return &data_[d * size_]; }
+
+    [[nodiscard]] Point point(const size_t i) const {
+        auto ret = Point::rep(dimensions_, 0);
+        for (size_t d = 0; d < dimensions_; d++) {
+            ret[d] = data_[d * size_ + i];
+        }
+        return ret;
+    }
+
+    // copies the i-th individual of `from` into the j-th place
+    void assign(const size_t j, const Population& from, const size_t i) {
+        for (size_t d = 0; d < dimensions_; d++) {
+            data_[d * size_ + j] = from.data_[d * from.size_ + i];
+        }
+    }
+
+    void clamp(const Area& where) {
+        for (size_t d = 0; d < dimensions_; d++) {
+            auto* row = coordinate(d);
+            const auto lo = where.min()[d], hi = where.max()[d];
+            for (size_t i = 0; i < size_; i++) {
+                row[i] = std::clamp(row[i], lo, hi);
+            }
+        }
+    }
+
+    // the whole population as one parallel batch
+    [[nodiscard]] std::vector<double> evaluate(const FunctionI& func) const {
+        auto points = std::vector<Point>(size_);
+        for (size_t i = 0; i < size_; i++) {
+            points[i] = point(i);
+        }
+        return func.evaluate_batch(points);
+    }
+};
+
+
+#endif //POPULATION_H
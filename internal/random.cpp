@@ -5,9 +5,19 @@ double random::gen(const double min, const double max) {
     return std::uniform_real_distribution(min, max)(random::engine());
 }
 
+double random::normal(const double mean, const double stddev) {
+    return std::normal_distribution(mean, stddev)(random::engine());
+}
+
+static thread_local std::mt19937_64* own_engine = nullptr;
+
 std::mt19937_64& random::engine() {
     static std::mt19937_64 engine_(1);
-    return engine_;
+    return own_engine != nullptr ? *own_engine : engine_;
+}
+
+void random::with_engine(std::mt19937_64* engine) {
+    own_engine = engine;
 }
 
 bool random::with_chance(const double chance) {
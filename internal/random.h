@@ -7,8 +7,15 @@ class random {
 public:
     static double gen(double min, double max);
 
+    static double normal(double mean = 0, double stddev = 1);
+
+    // the calling thread's own engine when it has one (see with_engine), the shared one otherwise
     static std::mt19937_64& engine();
 
+    // gives the calling thread its own engine, nullptr returns it to the shared one;
+    // threads running at the same time must not share an engine
+    static void with_engine(std::mt19937_64* engine);
+
     static bool with_chance(double chance);
 };
 
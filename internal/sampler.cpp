@@ -0,0 +1,199 @@
+#include "sampler.h"
+
+#include "random.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fmt/format.h>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+
+void UniformSampler::generate(const size_t count, const size_t dimensions, double* out) {
+    for (size_t i = 0; i < count * dimensions; i++) {
+        out[i] = random::gen(0, 1);
+    }
+}
+
+
+// a * b modulo the polynomial of the given degree, over GF(2)
+static uint64_t multiply_modulo(uint64_t a, uint64_t b, const uint64_t polynomial, const unsigned degree) {
+    uint64_t ret = 0;
+    while (b != 0) {
+        if (b & 1) {
+            ret ^= a;
+        }
+        b >>= 1;
+        a <<= 1;
+        if (a >> degree & 1) {
+            a ^= polynomial;
+        }
+    }
+    return ret;
+}
+
+static uint64_t power_modulo(uint64_t base, uint64_t exponent, const uint64_t polynomial, const unsigned degree) {
+    uint64_t ret = 1;
+    while (exponent != 0) {
+        if (exponent & 1) {
+            ret = multiply_modulo(ret, base, polynomial, degree);
+        }
+        base = multiply_modulo(base, base, polynomial, degree);
+        exponent >>= 1;
+    }
+    return ret;
+}
+
+// x generates the multiplicative group modulo the polynomial, i.e. its order is 2^degree - 1
+static bool is_primitive(const uint64_t polynomial, const unsigned degree) {
+    const auto order = (uint64_t{1} << degree) - 1;
+    if (power_modulo(2, order, polynomial, degree) != 1) {
+        return false;
+    }
+    auto rest = order;
+    for (uint64_t q = 2; q * q <= rest; q++) {
+        if (rest % q != 0) {
+            continue;
+        }
+        while (rest % q == 0) {
+            rest /= q;
+        }
+        if (power_modulo(2, order / q, polynomial, degree) == 1) {
+            return false;
+        }
+    }
+    return rest == 1 || power_modulo(2, order / rest, polynomial, degree) != 1;
+}
+
+void SobolSampler::restart(const size_t dimensions) {
+    dimensions_ = dimensions;
+    index_ = 0;
+    directions_.assign(dimensions * 32, 0);
+    current_.assign(dimensions, 0);
+    shift_.resize(dimensions);
+    for (auto& shift : shift_) {
+        shift = static_cast<uint32_t>(random::engine()());
+    }
+
+    // the first dimension is the van der Corput sequence
+    for (unsigned k = 0; k < 32; k++) {
+        directions_[k] = uint32_t{1} << (31 - k);
+    }
+
+    // fixed, so the sequence only depends on the shift
+    auto initial = std::mt19937(20231);
+    unsigned degree = 1;
+    uint64_t interior = 0; // the coefficients between the leading and the constant ones
+    for (size_t d = 1; d < dimensions; d++) {
+        uint64_t polynomial;
+        while (true) {
+            if (interior >> (degree - 1) != 0) {
+                degree += 1;
+                interior = 0;
+            }
+            polynomial = uint64_t{1} << degree | interior << 1 | 1;
+            interior += 1;
+            if (is_primitive(polynomial, degree)) {
+                break;
+            }
+        }
+
+        auto* v = &directions_[d * 32];
+        for (unsigned k = 0; k < degree && k < 32; k++) {
+            // odd and below 2^(k + 1)
+            const auto m = static_cast<uint32_t>(initial() % (uint32_t{1} << k)) * 2 + 1;
+            v[k] = m << (31 - k);
+        }
+        for (unsigned k = degree; k < 32; k++) {
+            v[k] = v[k - degree] ^ (v[k - degree] >> degree);
+            for (unsigned i = 1; i < degree; i++) {
+                if (polynomial >> (degree - i) & 1) {
+                    v[k] ^= v[k - i];
+                }
+            }
+        }
+    }
+}
+
+void SobolSampler::generate(const size_t count, const size_t dimensions, double* out) {
+    if (dimensions != dimensions_) {
+        restart(dimensions);
+    }
+    constexpr auto scale = 1.0 / 4294967296.0;
+    for (size_t i = 0; i < count; i++) {
+        if (index_ != 0) {
+            const auto k = static_cast<unsigned>(std::countr_zero(index_));
+            for (size_t d = 0; d < dimensions; d++) {
+                current_[d] ^= directions_[d * 32 + k];
+            }
+        }
+        index_ += 1;
+        for (size_t d = 0; d < dimensions; d++) {
+            out[i * dimensions + d] = (current_[d] ^ shift_[d]) * scale;
+        }
+    }
+}
+
+
+void HaltonSampler::restart(const size_t dimensions) {
+    dimensions_ = dimensions;
+    index_ = 1; // the 0-th point is the origin in every base
+    bases_.clear();
+    for (uint32_t candidate = 2; bases_.size() < dimensions; candidate++) {
+        if (std::ranges::none_of(bases_, [candidate](const uint32_t p) { return candidate % p == 0; })) {
+            bases_.push_back(candidate);
+        }
+    }
+    shift_.resize(dimensions);
+    for (auto& shift : shift_) {
+        shift = random::gen(0, 1);
+    }
+}
+
+void HaltonSampler::generate(const size_t count, const size_t dimensions, double* out) {
+    if (dimensions != dimensions_) {
+        restart(dimensions);
+    }
+    for (size_t i = 0; i < count; i++, index_++) {
+        for (size_t d = 0; d < dimensions; d++) {
+            const auto base = bases_[d];
+            double inverse = 0, digit = 1.0 / base;
+            for (auto n = index_; n != 0; n /= base, digit /= base) {
+                inverse += static_cast<double>(n % base) * digit;
+            }
+            const auto shifted = inverse + shift_[d];
+            out[i * dimensions + d] = shifted >= 1 ? shifted - 1 : shifted;
+        }
+    }
+}
+
+
+void LatinHypercubeSampler::generate(const size_t count, const size_t dimensions, double* out) {
+    auto strata = std::vector<size_t>(count);
+    for (size_t d = 0; d < dimensions; d++) {
+        std::iota(strata.begin(), strata.end(), 0);
+        std::ranges::shuffle(strata, random::engine());
+        for (size_t i = 0; i < count; i++) {
+            out[i * dimensions + d] = (static_cast<double>(strata[i]) + random::gen(0, 1)) / count;
+        }
+    }
+}
+
+
+std::shared_ptr<Sampler> make_sampler(const std::string_view name) {
+    if (name == "uniform") {
+        return std::make_shared<UniformSampler>();
+    }
+    if (name == "sobol") {
+        return std::make_shared<SobolSampler>();
+    }
+    if (name == "halton") {
+        return std::make_shared<HaltonSampler>();
+    }
+    if (name == "lhs") {
+        return std::make_shared<LatinHypercubeSampler>();
+    }
+    throw std::invalid_argument(fmt::format("unknown sampler '{}', should be uniform, sobol, halton or lhs", name));
+}
@@ -0,0 +1,77 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// Sampler: a source of points of the unit cube [0, 1)^n, Area::sample maps them onto an area.
+// Low-discrepancy sequences cover the cube more evenly than independent uniform points,
+// so initial simplexes, populations and global jumps need fewer evaluations to find the basins.
+class Sampler {
+public:
+    virtual ~Sampler() = default;
+
+    [[nodiscard]] virtual std::string name() const = 0;
+
+    // the next `count` points, out[i * dimensions + d] is the d-th coordinate of the i-th one;
+    // a sequence restarts when the dimensions change
+    virtual void generate(size_t count, size_t dimensions, double* out) = 0;
+};
+
+// UniformSampler: independent uniform points from random::engine(), what Area::random_point does
+class UniformSampler final : public Sampler {
+public:
+    [[nodiscard]] std::string name() const override { return "uniform"; }
+
+    void generate(size_t count, size_t dimensions, double* out) override;
+};
+
+// SobolSampler: Sobol' sequence in Gray code order, scrambled by a random digital shift.
+// Primitive polynomials are enumerated by degree, initial direction numbers are fixed odd pseudo-random ones.
+class SobolSampler final : public Sampler {
+    size_t dimensions_ = 0;
+    uint32_t index_ = 0;
+    std::vector<uint32_t> directions_; // directions_[d * 32 + k], the k-th direction number of dimension d
+    std::vector<uint32_t> current_;    // the last point, not shifted
+    std::vector<uint32_t> shift_;
+
+    void restart(size_t dimensions);
+
+public:
+    [[nodiscard]] std::string name() const override { return "sobol"; }
+
+    void generate(size_t count, size_t dimensions, double* out) override;
+};
+
+// HaltonSampler: radical inverses in the first n prime bases, randomly shifted modulo 1 (Cranley–Patterson)
+class HaltonSampler final : public Sampler {
+    size_t dimensions_ = 0;
+    uint64_t index_ = 0;
+    std::vector<uint32_t> bases_;
+    std::vector<double> shift_;
+
+    void restart(size_t dimensions);
+
+public:
+    [[nodiscard]] std::string name() const override { return "halton"; }
+
+    void generate(size_t count, size_t dimensions, double* out) override;
+};
+
+// LatinHypercubeSampler: every call is a new design, each coordinate of the `count` points
+// falls into its own 1/count stratum
+class LatinHypercubeSampler final : public Sampler {
+public:
+    [[nodiscard]] std::string name() const override { return "lhs"; }
+
+    void generate(size_t count, size_t dimensions, double* out) override;
+};
+
+// uniform, sobol, halton or lhs
+std::shared_ptr<Sampler> make_sampler(std::string_view name);
+
+#endif //SAMPLER_H
@@ -4,7 +4,19 @@
 
 #include "../internal/method.h"
 #include "../internal/method_nelder_mead.h"
+#include "../internal/method_parallel_nelder_mead.h"
 #include "../internal/method_random_walk.h"
+#include "../internal/method_lbfgs.h"
+#include "../internal/method_cmaes.h"
+#include "../internal/method_differential_evolution.h"
+#include "../internal/method_particle_swarm.h"
+#include "../internal/method_hybrid.h"
+#include "../internal/method_portfolio.h"
+#include "../internal/method_branch_and_bound.h"
+#include "../internal/method_pattern_search.h"
+#include "../internal/function_process.h"
+#include "../internal/function_surrogate.h"
+#include "heatmap_render.h"
 
 #include <string>
 #include <string_view>
@@ -98,6 +110,27 @@ public:
     std::vector<std::shared_ptr<Function>> functions;
     Area area{{{-5, -5}}, {{5, 5}}};
 
+    // heatmap + path PNG export, one image per function and method
+    struct ImageExport {
+        std::string prefix;
+        int width, height;
+    };
+
+    std::optional<ImageExport> image;
+
+    // a fresh sampler of this kind is given to every method
+    std::optional<std::string> sampler;
+
+    // the methods race each other (see Portfolio) instead of running one after another
+    struct Race {
+        std::optional<double> target;
+    };
+
+    std::optional<Race> race;
+
+    // every method gets the function behind a fresh SurrogateFunction evaluating this fraction of a batch
+    std::optional<double> surrogate;
+
     explicit CLI(const std::vector<Argument>& args) : allowed_arguments_(args) {}
 
     [[nodiscard]]
@@ -140,20 +173,95 @@ public:
 
     int operator()() {
         try {
-            for (auto func : functions) {
-                for (auto method : methods) {
-                    auto [min, min_val] = method->minimal(func.get(), area);
-
-                    auto [closest, closest_val] = func->closest_minimal(min);
-                    fmt::print("Function: {} in {} | Method: {}\n"
-                               "\tResults in minimum at x={}, f(x)={} (in {} steps).\n"
-                               "\tThe closest theoretically known local minimum: y={}, f(y)={}\n"
-                               "\t||(x, f(x)) - (y, f(y))|| = {}))\n",
-                               func->name(), area.to_string(), method->name(),
-                               min, min_val, method->steps_took(),
-                               closest, closest_val,
-                               min.dist_with(closest, [func](const auto& p) { return (*func)(p); })
-                    );
+            // checked before any method runs, not on the first save
+            if (image.has_value() && area.dimensions() < 2) {
+                throw std::invalid_argument(fmt::format("image export needs at least 2 dimensions (the area has {})",
+                                                        area.dimensions()));
+            }
+            for (size_t f = 0; f < functions.size(); f++) {
+                const auto& func = functions[f];
+                // the 2-D heatmaps don't depend on the method, they are evaluated once per function
+                std::optional<std::pair<Slice, QImage>> background;
+
+                auto runs = methods;
+                if (race.has_value()) {
+                    for (const auto& method : methods) {
+                        if (sampler.has_value()) {
+                            method->with_sampler(make_sampler(sampler.value()));
+                        }
+                    }
+                    runs = {std::make_shared<Portfolio>(Log(Log::LEVEL::MUTED), methods, race->target)};
+                }
+
+                for (size_t m = 0; m < runs.size(); m++) {
+                    const auto& method = runs[m];
+                    if (sampler.has_value() && !race.has_value()) {
+                        method->with_sampler(make_sampler(sampler.value()));
+                    }
+                    auto screened = std::shared_ptr<SurrogateFunction>{};
+                    if (surrogate.has_value()) {
+                        screened = std::make_shared<SurrogateFunction>(func, surrogate.value());
+                    }
+                    auto [path, minima] = method->minimal_with_path(
+                        screened ? static_cast<Function*>(screened.get()) : func.get(), area);
+                    auto [min, min_val] = minima;
+
+                    if (func->minimal().empty()) {
+                        fmt::print("Function: {} in {} | Method: {}\n"
+                                   "\tResults in minimum at x={}, f(x)={} (in {} steps).\n",
+                                   func->name(), area.to_string(), method->name(),
+                                   min, min_val, method->steps_took()
+                        );
+                    } else {
+                        auto [closest, closest_val] = func->closest_minimal(min);
+                        fmt::print("Function: {} in {} | Method: {}\n"
+                                   "\tResults in minimum at x={}, f(x)={} (in {} steps).\n"
+                                   "\tThe closest theoretically known local minimum: y={}, f(y)={}\n"
+                                   "\t||(x, f(x)) - (y, f(y))|| = {}))\n",
+                                   func->name(), area.to_string(), method->name(),
+                                   min, min_val, method->steps_took(),
+                                   closest, closest_val,
+                                   min.dist_with(closest, [func](const auto& p) { return (*func)(p); })
+                        );
+                    }
+
+                    if (const auto* bnb = dynamic_cast<const BranchAndBound*>(method.get())) {
+                        fmt::print("\tCertified: no value in the area is below {}, {}% of the area pruned.\n",
+                                   bnb->lower_bound(), 100 * bnb->pruned());
+                    }
+                    if (const auto* portfolio = dynamic_cast<const Portfolio*>(method.get())) {
+                        const auto& outcomes = portfolio->outcomes();
+                        const auto& winner = outcomes[portfolio->winner()];
+                        fmt::print("\tWon by {} on its evaluation #{}.\n", winner.method,
+                                   winner.reached_at != 0 ? winner.reached_at : winner.best_at);
+                        for (const auto& outcome : outcomes) {
+                            fmt::print("\t\t{}: f(x)={} on evaluation #{} of {}, {}\n", outcome.method,
+                                       outcome.best.second, outcome.best_at, outcome.evaluations, outcome.status_name());
+                        }
+                    }
+
+                    if (screened) {
+                        const auto statistics = screened->statistics();
+                        fmt::print("\tSurrogate: {} of {} values predicted instead of evaluated ({}%).\n",
+                                   statistics.predicted, statistics.requested, 100 * statistics.saved());
+                    }
+
+                    if (image.has_value()) {
+                        // N-D areas are drawn as the (x_0, x_1) slice through the found minimum
+                        const auto slice = Slice{0, 1, min}.normalized(area);
+                        if (!background.has_value() || background->first != slice) {
+                            background = {slice, render_heatmap(evaluate_heatmap(
+                                              *func, area, image->width, image->height, 1, 1, slice))};
+                        }
+                        auto picture = background->second;
+                        draw_path(picture, area, path, slice);
+
+                        const auto filename = fmt::format("{}-f{}-m{}.png", image->prefix, f, m);
+                        if (!picture.save(QString::fromStdString(filename), "PNG")) {
+                            throw std::invalid_argument(fmt::format("can't write the image to '{}'", filename));
+                        }
+                        fmt::print("\tHeatmap with the path ({} points) is saved to {}\n", path.size(), filename);
+                    }
                 }
                 fmt::print("\n");
             }
@@ -232,6 +340,73 @@ int cli_app(int argc, char* argv[]) {
                 {"-N", "--nelder", "--nelder-mead"}, 1,
                 fmt::format("METHOD: use {}", NelderMead(Log::null()).name())
             },
+            // Nelder-Mead method with dimension-adaptive coefficients
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<NelderMead>(
+                        NelderMead(muted).with_adaptive_coefficients()));
+                },
+                {"-Na", "--nelder-adaptive"}, 1,
+                fmt::format("METHOD: use {}, coefficients derived from the dimensions (Gao-Han)",
+                            NelderMead(Log::null()).name())
+            },
+            // Nelder-Mead method with restarts
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<NelderMead>(
+                        NelderMead(muted).with_restarts(must_int64(args[1], true))));
+                },
+                {"-Nr", "--nelder-restarts"}, 2,
+                fmt::format("METHOD: use {}, restarted on stagnation, degeneracy and convergence,\n"
+                            "                                    REQUIRES: subargument <EVALUATIONS> -- the total budget",
+                            NelderMead(Log::null()).name())
+            },
+            // Parallel Nelder-Mead method
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<ParallelNelderMead>(
+                        muted, 0.01, must_int64(args[1], false)));
+                },
+                {"-Np", "--nelder-parallel"}, 2,
+                fmt::format("METHOD: use {}, the P worst vertices are updated as one parallel batch,\n"
+                            "                                    REQUIRES: subargument <P> -- 0 for the number of threads",
+                            ParallelNelderMead(Log::null()).name())
+            },
+            // global sampling followed by parallel Nelder-Mead descents
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<Hybrid>(
+                        muted, must_int64(args[1], true), must_int64(args[2], true), must_int64(args[3], true)));
+                },
+                {"-Y", "--hybrid"}, 4,
+                fmt::format("METHOD: use {}, REQUIRES: subarguments <SAMPLES> <BASINS> <EVALUATIONS> --\n"
+                            "                                    the points sampled, the descents started from the best\n"
+                            "                                    distinct ones and the budget of each descent",
+                            Hybrid(Log::null()).name())
+            },
+            // Branch and Bound method
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<BranchAndBound>(muted));
+                },
+                {"-B", "--branch-and-bound"}, 1,
+                fmt::format("METHOD: use {}, certified by interval bounds of the built-in functions",
+                            BranchAndBound(Log::null()).name())
+            },
+            // Pattern Search method
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<PatternSearch>(muted));
+                },
+                {"-J", "--pattern-search", "--hooke-jeeves"}, 1,
+                fmt::format("METHOD: use {}", PatternSearch(Log::null()).name())
+            },
             // RandomWalk method
             CLI::Argument{
                 [](CLI& cli, std::vector<std::string> args) {
@@ -241,6 +416,52 @@ int cli_app(int argc, char* argv[]) {
                 {"-W", "--walk", "--random-walk"}, 1,
                 fmt::format("METHOD: use {}", RandomWalk(Log::null()).name())
             },
+            // RandomWalk method, single coordinate moves
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<RandomWalk>(muted, 0.1, 0.9, 1e-5, 100, 100000, true));
+                },
+                {"-Wc", "--walk-coordinate-wise"}, 1,
+                fmt::format("METHOD: use {}, O(1) per local move for separable functions",
+                            RandomWalk(Log::null(), 0.1, 0.9, 1e-5, 100, 100000, true).name())
+            },
+            // L-BFGS method
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<LBFGS>(muted));
+                },
+                {"-L", "--lbfgs"}, 1,
+                fmt::format("METHOD: use {}", LBFGS(Log::null()).name())
+            },
+            // CMA-ES method
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<CMAES>(muted));
+                },
+                {"-C", "--cmaes"}, 1,
+                fmt::format("METHOD: use {}", CMAES(Log::null()).name())
+            },
+            // Differential Evolution method
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<DifferentialEvolution>(muted));
+                },
+                {"-D", "--differential-evolution"}, 1,
+                fmt::format("METHOD: use {}", DifferentialEvolution(Log::null()).name())
+            },
+            // Particle Swarm method
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    auto muted = Log(Log::LEVEL::MUTED);
+                    cli.methods.emplace_back(std::make_shared<ParticleSwarm>(muted));
+                },
+                {"-S", "--swarm", "--particle-swarm"}, 1,
+                fmt::format("METHOD: use {}", ParticleSwarm(Log::null()).name())
+            },
 
             // Himmelblau function
             CLI::Argument{
@@ -283,6 +504,17 @@ int cli_app(int argc, char* argv[]) {
                     RastriginFunction(3).minimal()
                 )
             },
+            // External process function
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    const auto workers = must_int64(args[2], true);
+                    cli.functions.emplace_back(std::make_shared<ProcessFunction>(customSplit(args[1], ' '), workers));
+                },
+                {"-P", "--process"}, 3,
+                "FUNCTION: evaluated by external worker processes, REQUIRES: subarguments <COMMAND> <WORKERS>.\n"
+                "                                    Each worker reads '<ID> <X_1> ... <X_N>' lines and answers '<ID> <VALUE>',\n"
+                "                                    e.g. -P ./sphere_worker 4"
+            },
 
             // Area
             CLI::Argument{
@@ -344,6 +576,59 @@ int cli_app(int argc, char* argv[]) {
                 "seed for the random number generator"
             },
 
+            // Sampler
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    make_sampler(args[1]); // validates the name
+                    cli.sampler = args[1];
+                },
+                {"-smp", "--sampler"}, 2,
+                "where initial and global points come from, REQUIRES: subargument <NAME>,\n"
+                "                                    one of uniform (default), sobol, halton, lhs (Latin hypercube)"
+            },
+
+            // Portfolio racing
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    cli.race = CLI::Race{};
+                    if (args[1] != "none") {
+                        cli.race->target = must_double(args[1]);
+                    }
+                },
+                {"-pf", "--portfolio"}, 2,
+                "race all the methods at once, they share the best value found and stop when one reaches\n"
+                "                                    the target or falls hopelessly behind, REQUIRES: subargument <TARGET> or none"
+            },
+
+            // Surrogate screening
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    const auto fraction = must_double(args[1]);
+                    if (!(fraction > 0 && fraction <= 1)) {
+                        throw std::invalid_argument(fmt::format("{} has to be in (0, 1] (got {})", args[0], args[1]));
+                    }
+                    cli.surrogate = fraction;
+                },
+                {"-sg", "--surrogate"}, 2,
+                "screen the points with a radial basis function model of the values seen, for expensive functions,\n"
+                "                                    REQUIRES: subargument <FRACTION> of a batch evaluated, in (0, 1]"
+            },
+
+            // Image export
+            CLI::Argument{
+                [](CLI& cli, std::vector<std::string> args) {
+                    cli.image = CLI::ImageExport{
+                        args[1],
+                        static_cast<int>(must_int64(args[2], true)),
+                        static_cast<int>(must_int64(args[3], true)),
+                    };
+                },
+                {"-i", "--image"}, 4,
+                "save the heatmap with the path of every function and method to <PREFIX>-f<I>-m<J>.png,\n"
+                "                                    REQUIRES: subarguments <PREFIX> <WIDTH> <HEIGHT>, N-d areas are drawn as\n"
+                "                                    the (x_0, x_1) slice through the found minimum"
+            },
+
             // Help
             CLI::Argument{
                 [](CLI& cli, std::vector<std::string> args) {
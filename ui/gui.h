@@ -2,6 +2,7 @@
 #define GUI_H
 
 #include "../internal/function.h"
+#include "../internal/function_cancellable.h"
 #include "gui_settings.h"
 
 #include <QApplication>
@@ -11,7 +12,12 @@
 #include <QDialog>
 #include <QVBoxLayout>
 #include <QRadioButton>
+#include <QTimer>
 #include <set>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include <fmt/format.h>
 
@@ -23,57 +29,96 @@ class MainWindow final : public QMainWindow {
     HeatmapWidget* heatmap_widget_;
     QLabel* info_;
     SettingsDialog settingsDialog_;
+    QTimer resizeTimer_;
+
+    // the optimization runs here, a newer run cancels the previous one
+    std::thread worker_;
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+    std::string signature_;
+
+    // path points found by the running method, drained into the heatmap at most 30 times a second
+    struct PathStream {
+        std::mutex mutex;
+        std::vector<Point> points;
+    };
+
+    std::shared_ptr<PathStream> stream_;
+    QTimer frameTimer_;
 
 public:
     explicit MainWindow(QApplication* wraps)
         : application_(wraps), heatmap_widget_(new HeatmapWidget(this)), info_(new QLabel("example", this)) {
         setMinimumSize(400, 300);
         setWindowTitle("Function Minima");
+
+        // resizes only relayout, once the user stops dragging
+        resizeTimer_.setSingleShot(true);
+        QObject::connect(&resizeTimer_, &QTimer::timeout, [this]() {
+            relayout();
+            heatmap_widget_->update();
+        });
+
+        QObject::connect(&frameTimer_, &QTimer::timeout, [this]() {
+            drain();
+        });
+
         resize(800, 600);
+        relayout();
         graph_update(false);
     }
 
-    void graph_update(bool save_start) const {
+    ~MainWindow() override {
+        cancel();
+    }
+
+    void relayout() const {
+        heatmap_widget_->setGeometry(0, 30, width(), height() - 100);
+        info_->setGeometry(20, height() - 80, width() - 20, 80);
+    }
+
+    void graph_update(bool save_start) {
         try {
-            heatmap_widget_->setGeometry(0, 30, width(), height() - 100);
             auto experiment = settingsDialog_.getExperiment();
-            const auto [pixelSize, sampleDensity, drawGraph, seed] = settingsDialog_.getGraphConfiguration();
-            random::engine() = std::mt19937_64(seed);
-            heatmap_widget_->draw(drawGraph);
+            const auto [pixelSize, sampleDensity, drawGraph, seed, sliceX, sliceY, smallMultiples] =
+                settingsDialog_.getGraphConfiguration();
+            if (const auto dims = experiment.area->dimensions(); sliceX >= dims || sliceY >= dims || sliceX == sliceY) {
+                throw std::invalid_argument(fmt::format("slice axes must be distinct and less than {}", dims));
+            }
+            heatmap_widget_->draw(drawGraph)->with_slice(sliceX, sliceY, smallMultiples);
 
+            auto signature = settingsDialog_.signature();
+            std::optional<Point> origin;
             if (save_start) {
                 if (const auto start = heatmap_widget_->start(); start.has_value()) {
+                    origin = start;
                     experiment.method->with_start(start.value());
+                    signature += fmt::format("|start={}", start.value());
                 }
             }
-            auto [path, mimima] = experiment.method->minimal_with_path(&*experiment.function, *experiment.area);
-            experiment.path = path;
 
             heatmap_widget_->
-                with(experiment)->
                 with(sampleDensity, pixelSize)->
                 with([this](bool flag) {
                     this->graph_update(flag);
                 });
-            heatmap_widget_->update();
 
-            info_->setGeometry(20, height() - 80, width() - 20, 80);
-            const auto text = fmt::format(">> {}. {}.\n"
-                                          "Mimima: {}. Drawn path len: {}.\n"
-                                          "Closest known minima: {}, MSE: {}.",
-                                          experiment.function->name(), experiment.method->name(),
-                                          mimima.first, path.size(),
-                                          experiment.function->closest_minimal(mimima.first).first,
-                                          experiment.function->closest_minimal(mimima.first).first.dist(mimima.first)
-            );
-            info_->setText(QString::fromStdString(text));
+            // nothing has changed, no need to optimize again
+            if (signature == signature_) {
+                heatmap_widget_->update();
+                return;
+            }
+            signature_ = std::move(signature);
+
+            heatmap_widget_->with(experiment)->with_origin(origin);
+            heatmap_widget_->update();
+            optimize(std::move(experiment), seed);
         } catch (const std::exception& e) {
             QMessageBox::critical(heatmap_widget_, "Unexpected error", e.what());
         }
     }
 
     void resizeEvent(QResizeEvent* event) override {
-        graph_update(true);
+        resizeTimer_.start(150);
     }
 
     int start() {
@@ -85,9 +130,115 @@ public:
             }
         });
 
+        QPushButton stopButton("Stop", this);
+        stopButton.setGeometry(80, 0, 80, 30);
+        QObject::connect(&stopButton, &QPushButton::clicked, [this]() {
+            stop();
+        });
+
         show();
         return application_->exec();
     }
+
+private:
+    void cancel() {
+        if (cancelled_) {
+            *cancelled_ = true;
+        }
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+        frameTimer_.stop();
+    }
+
+    // the current run is over (its thread has only to return), so Stop has nothing to stop
+    void finish() {
+        frameTimer_.stop();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    void stop() {
+        if (!cancelled_ || *cancelled_ || !worker_.joinable()) {
+            return;
+        }
+        cancel();
+        drain();
+        signature_.clear(); // the run is incomplete, OK with the same settings runs it again
+        info_->setText(info_->text() + QString::fromStdString(
+                           fmt::format(" Stopped, drawn path len: {}.", heatmap_widget_->path_size())));
+    }
+
+    void drain() {
+        if (!stream_) {
+            return;
+        }
+        std::vector<Point> points;
+        {
+            std::lock_guard lock(stream_->mutex);
+            points.swap(stream_->points);
+        }
+        if (!points.empty()) {
+            heatmap_widget_->append(points);
+            heatmap_widget_->update();
+        }
+    }
+
+    void optimize(Experiment experiment, const int seed) {
+        cancel();
+        cancelled_ = std::make_shared<std::atomic<bool>>(false);
+        stream_ = std::make_shared<PathStream>();
+        experiment.method->with_observer([stream = stream_](const Point& point) {
+            std::lock_guard lock(stream->mutex);
+            stream->points.push_back(point);
+        });
+        frameTimer_.start(33);
+        info_->setText(QString::fromStdString(fmt::format(">> {}. {}.\nOptimizing...",
+                                                          experiment.function->name(),
+                                                          experiment.method->name())));
+
+        worker_ = std::thread([this, experiment = std::move(experiment), seed, cancelled = cancelled_]() mutable {
+            try {
+                random::engine() = std::mt19937_64(seed);
+                auto function = CancellableFunction(experiment.function, cancelled);
+                auto [path, minima] = experiment.method->minimal_with_path(&function, *experiment.area);
+                experiment.path = std::move(path);
+                QMetaObject::invokeMethod(this, [this, experiment, minima, cancelled] {
+                    if (!*cancelled) {
+                        finish();
+                        show_result(experiment, minima);
+                    }
+                }, Qt::QueuedConnection);
+            } catch (const Cancelled&) {
+                // superseded by a newer run
+            } catch (const std::exception& e) {
+                QMetaObject::invokeMethod(this, [this, message = std::string(e.what()), cancelled] {
+                    if (!*cancelled) {
+                        finish();
+                        signature_.clear();
+                        QMessageBox::critical(heatmap_widget_, "Unexpected error", QString::fromStdString(message));
+                    }
+                }, Qt::QueuedConnection);
+            }
+        });
+    }
+
+    void show_result(const Experiment& experiment, const Function::Value& mimima) {
+        // the N-D slices go through the found minimum
+        heatmap_widget_->with(experiment)->with_origin(mimima.first);
+        heatmap_widget_->update();
+
+        const auto closest = experiment.function->closest_minimal(mimima.first).first;
+        const auto text = fmt::format(">> {}. {}.\n"
+                                      "Mimima: {}. Drawn path len: {}.\n"
+                                      "Closest known minima: {}, MSE: {}.",
+                                      experiment.function->name(), experiment.method->name(),
+                                      mimima.first, experiment.path.size(),
+                                      closest, closest.dist(mimima.first)
+        );
+        info_->setText(QString::fromStdString(text));
+    }
 };
 
 #endif //GUI_H
@@ -2,14 +2,28 @@
 #define GUI_HEATMAP_H
 
 #include "../internal/function.h"
+#include "heatmap_render.h"
 
 #include <QWidget>
 #include <QPainter>
+#include <QMetaObject>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
 
 class HeatmapWidget final : public QWidget {
 public:
     explicit HeatmapWidget(QWidget* parent = nullptr) : QWidget(parent) {}
 
+    ~HeatmapWidget() override {
+        generation_ += 1;
+        if (render_thread_.joinable()) {
+            render_thread_.join();
+        }
+    }
+
     HeatmapWidget* rate(const size_t rate) {
         rate_ = rate;
         return this;
@@ -27,44 +41,68 @@ public:
             return;
         }
 
-        for (size_t x = 0; x < width; x += pixel_size_) {
-            for (size_t y = 0; y < height; y += pixel_size_) {
-                double sum = 0.0;
-                int count = 0;
-
-                for (size_t i = x; i < x + pixel_size_; i += rate_) {
-                    for (size_t j = y; j < y + pixel_size_; j += rate_) {
-                        double realX = /*1 - */experiment_.area->percentile(0, static_cast<double>(i) / width);
-                        double realY = experiment_.area->percentile(1, static_cast<double>(j) / height);
-                        sum += (*experiment_.function)({{realX, realY}});
-                        count++;
-                    }
-                }
+        const auto panels = layout_panels(width, height);
+        std::vector<CacheKey> incomplete;
+        size_t outside = 0;
+        for (size_t k = 0; k < panels.size(); k++) {
+            const auto& panel = panels[k];
+            const auto& rendered = cached(panel.key);
+            if (!rendered.complete) {
+                incomplete.push_back(panel.key);
+            }
 
-                const double averageResult = sum / count;
-                const double temperature = std::min(map(averageResult, 0.0, 100.0, 0.0, 1.0), 0.9999);
-                QColor color = temperatureToColor(temperature);
-                painter.fillRect(x, height - y - 1, pixel_size_, pixel_size_, color);
+            const auto left = panel.rect.left(), top = panel.rect.top();
+            const auto panelWidth = panel.rect.width(), panelHeight = panel.rect.height();
+            // the field is rounded up to whole cells, it mustn't spill over the neighbouring panels
+            painter.setClipRect(panel.rect);
+            if (rendered.image.isNull()) {
+                painter.fillRect(panel.rect, QColor{255, 255, 255});
+            } else {
+                const auto fieldWidth = static_cast<int>(rendered.image.width() * rendered.cell);
+                const auto fieldHeight = static_cast<int>(rendered.image.height() * rendered.cell);
+                painter.drawImage(QRect{left, top + panelHeight - fieldHeight, fieldWidth, fieldHeight},
+                                  rendered.image);
+            }
+
+            const auto& path = polyline(k, panel);
+            outside += path.outside;
+            auto drawn = path.polyline;
+            drawn.translate(left, top);
+            painter.setPen({97, 222, 42});
+            painter.drawPolyline(drawn);
+            painter.setClipping(false);
+
+            if (experiment_.area->dimensions() > 2 || panels.size() > 1) {
+                painter.setPen(QColor{255, 255, 255});
+                painter.drawText(left + 6, top + 16, QString::fromStdString(
+                                     fmt::format("x{} / x{}", panel.key.slice.x, panel.key.slice.y)));
+                painter.drawRect(panel.rect.adjusted(0, 0, -1, -1));
             }
         }
 
-        painter.setPen({97, 222, 42});
-        for (size_t i = 1; i < experiment_.path.size(); i++) {
-            const auto left = experiment_.area->point_to_percentile(experiment_.path[i - 1]);
-            const auto right = experiment_.area->point_to_percentile(experiment_.path[i]);
-            painter.drawLine(QPoint{
-                                 static_cast<int>(left.first * width),
-                                 height - 1 - static_cast<int>(left.second * height)
-                             },
-                             QPoint{
-                                 static_cast<int>(right.first * width),
-                                 height - 1 - static_cast<int>(right.second * height)
-                             });
+        // a newer render cancels the running one, so it gets all the incomplete fields
+        if (std::ranges::any_of(incomplete, [this](const CacheKey& key) {
+            return std::ranges::find(rendering_, key) == rendering_.end();
+        })) {
+            render_fields(std::move(incomplete));
+        }
+        if (outside != 0 && outside != warned_outside_) {
+            warned_outside_ = outside;
+            fmt::print(stderr, "WARN: {} of {} path points are not exactly in the area\n",
+                       outside, experiment_.path.size());
         }
     }
 
     HeatmapWidget* with(const Experiment& experiment) {
         experiment_ = experiment;
+        path_revision_ += 1;
+        return this;
+    }
+
+    // extends the drawn path, for paths streamed while the method runs
+    HeatmapWidget* append(const std::vector<Point>& points) {
+        experiment_.path.insert(experiment_.path.end(), points.begin(), points.end());
+        path_revision_ += 1;
         return this;
     }
 
@@ -84,41 +122,202 @@ public:
         return this;
     }
 
-    void mousePressEvent(QMouseEvent* event) override {
-        if (event->button() == Qt::LeftButton && experiment_.area->dimensions() == 2) {
-            const int width = this->width();
-            const int height = this->height();
-            double realX = experiment_.area->percentile(0, static_cast<double>(event->pos().x()) / width);
-            double realY = experiment_.area->percentile(1, static_cast<double>(height - event->pos().y()) / height);
+    // the slice axes, or a grid of all axis pairs if small_multiples is set
+    HeatmapWidget* with_slice(const size_t x, const size_t y, const bool small_multiples) {
+        slice_x_ = x;
+        slice_y_ = y;
+        small_multiples_ = small_multiples;
+        return this;
+    }
+
+    // the point the N-D slices pass through, the center of the area if not set
+    HeatmapWidget* with_origin(const std::optional<Point>& origin) {
+        origin_ = origin;
+        return this;
+    }
 
-            start_ = {{{realX, realY}}};
+    void mousePressEvent(QMouseEvent* event) override {
+        if (event->button() != Qt::LeftButton) {
+            return;
+        }
+        for (const auto& panel : layout_panels(this->width(), this->height())) {
+            if (!panel.rect.contains(event->pos())) {
+                continue;
+            }
+            const auto u = static_cast<double>(event->pos().x() - panel.rect.left()) / panel.rect.width();
+            const auto v = static_cast<double>(panel.rect.bottom() + 1 - event->pos().y()) / panel.rect.height();
+            start_ = panel.key.slice.normalized(*experiment_.area).point(*experiment_.area, u, v);
             callback_(true);
+            return;
         }
     }
 
+    [[nodiscard]]
+    size_t path_size() const {
+        return experiment_.path.size();
+    }
+
     [[nodiscard]]
     std::optional<Point> start() const {
         return start_;
     };
 
 private:
+    struct CacheKey {
+        std::string function;
+        Area area;
+        Slice slice; // normalized, so the 2-D keys don't depend on the origin
+        size_t width, height, pixel_size, rate;
+
+        bool operator==(const CacheKey& other) const = default;
+    };
+
+    struct Rendered {
+        CacheKey key;
+        QImage image;          // the latest stage, null until the first one is ready
+        size_t cell{};         // on-screen size of a pixel of the image
+        bool complete = false; // the last stage is in
+        size_t used{};         // for the eviction of the least recently used
+    };
+
+    struct Panel {
+        CacheKey key;
+        QRect rect;
+    };
+
+    // the path's polyline over a panel, simplifying up to 1e6 points isn't for every frame
+    struct Polyline {
+        std::optional<Area> area; // none until built
+        Slice slice;
+        int width{}, height{};
+        size_t revision{};
+        QPolygonF polyline;
+        size_t outside{};
+    };
+
+    static constexpr size_t CACHE_SIZE = 64;
+
     Experiment experiment_;
+    std::vector<Rendered> cache_;
+    size_t cache_clock_ = 0;
+    std::vector<CacheKey> rendering_; // the keys of the running render
+    std::thread render_thread_;
+    std::atomic<size_t> generation_ = 0; // bumped to cancel the running render
     std::function<void(bool)> callback_;
     std::optional<Point> start_;
+    std::optional<Point> origin_;
+    size_t slice_x_ = 0, slice_y_ = 1;
+    bool small_multiples_ = false;
     size_t rate_ = 3, pixel_size_ = 8;
+    size_t warned_outside_ = 0;
+    size_t path_revision_ = 1; // bumped whenever the path changes, 0 is never drawn
+    std::vector<Polyline> polylines_; // one per panel
     bool draw_ = true;
 
-    static QColor temperatureToColor(double temperature) {
-        int r = static_cast<int>(255 * pow(temperature, 3));
-        int b = static_cast<int>(255 * pow(1 - temperature, 3));
-        if (r > 255 || b > 255) {
-            return {r, 0, 0};
+    // the slices to draw, in a ceil(sqrt(k)) columns grid
+    [[nodiscard]] std::vector<Panel> layout_panels(const int width, const int height) const {
+        const auto& area = *experiment_.area;
+        const auto origin = origin_.value_or(Point{});
+
+        std::vector<Slice> slices;
+        if (small_multiples_ && area.dimensions() > 2) {
+            for (size_t x = 0; x < area.dimensions(); x++) {
+                for (size_t y = x + 1; y < area.dimensions(); y++) {
+                    slices.push_back(Slice{x, y, origin}.normalized(area));
+                }
+            }
+        } else {
+            slices.push_back(Slice{slice_x_, slice_y_, origin}.normalized(area));
+        }
+
+        const auto columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(slices.size()))));
+        const auto rows = (static_cast<int>(slices.size()) + columns - 1) / columns;
+        const auto panelWidth = width / columns, panelHeight = height / rows;
+
+        std::vector<Panel> ret;
+        for (size_t k = 0; k < slices.size(); k++) {
+            const auto column = static_cast<int>(k) % columns, row = static_cast<int>(k) / columns;
+            ret.push_back(Panel{
+                CacheKey{
+                    experiment_.function->name(), area, std::move(slices[k]),
+                    static_cast<size_t>(panelWidth), static_cast<size_t>(panelHeight), pixel_size_, rate_
+                },
+                QRect{column * panelWidth, row * panelHeight, panelWidth, panelHeight}
+            });
+        }
+        return ret;
+    }
+
+    // the panel's polyline, rebuilt only if the path or the panel has changed
+    const Polyline& polyline(const size_t k, const Panel& panel) {
+        if (polylines_.size() <= k) {
+            polylines_.resize(k + 1);
+        }
+        auto& cached = polylines_[k];
+        const auto width = panel.rect.width(), height = panel.rect.height();
+        if (cached.revision != path_revision_ || cached.area != *experiment_.area || cached.slice != panel.key.slice
+            || cached.width != width || cached.height != height) {
+            cached = Polyline{*experiment_.area, panel.key.slice, width, height, path_revision_, {}, 0};
+            cached.polyline = path_polyline(*cached.area, experiment_.path, width, height, &cached.outside,
+                                            cached.slice);
+        }
+        return cached;
+    }
+
+    // the cache entry of the key, a new empty one if there is none
+    Rendered& cached(const CacheKey& key) {
+        cache_clock_ += 1;
+        if (const auto it = std::ranges::find(cache_, key, &Rendered::key); it != cache_.end()) {
+            it->used = cache_clock_;
+            return *it;
         }
-        return {r, 0, b};
+        if (cache_.size() >= CACHE_SIZE) {
+            cache_.erase(std::ranges::min_element(cache_, {}, &Rendered::used));
+        }
+        return cache_.emplace_back(Rendered{key, {}, {}, false, cache_clock_});
     }
 
-    static double map(double value, double start1, double end1, double start2, double end2) {
-        return (start2 + (end2 - start2) * ((value - start1) / (end1 - start1)));
+    // evaluates the fields coarse-to-fine in the background one by one, every stage replaces the cached image
+    void render_fields(std::vector<CacheKey> keys) {
+        const auto generation = ++generation_;
+        if (render_thread_.joinable()) {
+            render_thread_.join();
+        }
+        rendering_ = keys;
+
+        render_thread_ = std::thread([this, generation, keys = std::move(keys), function = experiment_.function] {
+            auto post = [this, generation](const CacheKey& key, auto apply) {
+                QMetaObject::invokeMethod(this, [this, generation, key, apply = std::move(apply)] {
+                    if (generation_ != generation) {
+                        return;
+                    }
+                    if (const auto it = std::ranges::find(cache_, key, &Rendered::key); it != cache_.end()) {
+                        apply(*it);
+                        update();
+                    }
+                }, Qt::QueuedConnection);
+            };
+
+            for (const auto& key : keys) {
+                try {
+                    const auto finished = evaluate_heatmap_progressive(
+                        *function, key.area, key.width, key.height, key.pixel_size, key.rate, key.slice,
+                        [this, generation] { return generation_ != generation; },
+                        [&](const HeatmapField& field, const size_t cell) {
+                            post(key, [cell, image = render_heatmap(field)](Rendered& rendered) {
+                                rendered.image = image;
+                                rendered.cell = cell;
+                            });
+                        });
+                    if (!finished) {
+                        return;
+                    }
+                    post(key, [](Rendered& rendered) { rendered.complete = true; });
+                } catch (const std::exception& e) {
+                    fmt::print(stderr, "WARN: heatmap rendering has failed: {}\n", e.what());
+                }
+            }
+        });
     }
 };
 
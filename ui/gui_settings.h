@@ -7,7 +7,15 @@
 
 #include "../internal/method.h"
 #include "../internal/method_nelder_mead.h"
+#include "../internal/method_parallel_nelder_mead.h"
+#include "../internal/method_hybrid.h"
+#include "../internal/method_branch_and_bound.h"
+#include "../internal/method_pattern_search.h"
 #include "../internal/method_random_walk.h"
+#include "../internal/method_lbfgs.h"
+#include "../internal/method_cmaes.h"
+#include "../internal/method_differential_evolution.h"
+#include "../internal/method_particle_swarm.h"
 
 #include "parse.h"
 #include "gui_widgets.h"
@@ -37,6 +45,9 @@ public:
             static_cast<size_t>(must_int64(drawGraphDensity->edit->text().toStdString(), true)),
             flagDrawGraph->isChecked(),
             static_cast<int>(must_int64(otherSeed->edit->text().toStdString(), false)),
+            static_cast<size_t>(must_non_negative_int64(drawSliceX->edit->text().toStdString())),
+            static_cast<size_t>(must_non_negative_int64(drawSliceY->edit->text().toStdString())),
+            drawSmallMultiples->isChecked(),
         };
     }
 
@@ -57,7 +68,8 @@ public:
                     must_double(nelderMeadGamme->text().toStdString(), positive<double>),
                     must_double(nelderMeadRho->text().toStdString(), positive<double>),
                     must_double(nelderMeadSigma->text().toStdString(), positive<double>)
-                )
+                ).with_restarts(must_non_negative_int64(nelderMeadBudget->text().toStdString()))
+                 .with_adaptive_coefficients(nelderMeadAdaptive->isChecked())
             );
             break;
 
@@ -68,7 +80,84 @@ public:
                 must_double(randomWalkP->text().toStdString(), [](auto val) { return val >= 0 and val <= 1; }),
                 must_double(randomWalkStopEps->text().toStdString(), positive<double>),
                 must_int64(randomWalkMinSteps->text().toStdString(), false),
-                must_int64(randomWalkSteps->text().toStdString(), false)
+                must_int64(randomWalkSteps->text().toStdString(), false),
+                randomWalkCoordinateWise->isChecked()
+            );
+            break;
+
+        case 2:
+            method = std::make_shared<LBFGS>(
+                logger,
+                must_double(lbfgsStopEps->text().toStdString(), positive<double>),
+                must_int64(lbfgsMemory->text().toStdString(), true),
+                must_int64(lbfgsSteps->text().toStdString(), true)
+            );
+            break;
+
+        case 3:
+            method = std::make_shared<CMAES>(
+                logger,
+                must_double(cmaesStopEps->text().toStdString(), positive<double>),
+                must_non_negative_int64(cmaesRestarts->text().toStdString()),
+                must_int64(cmaesEvaluations->text().toStdString(), true),
+                must_double(cmaesSigma->text().toStdString(), positive<double>)
+            );
+            break;
+
+        case 4:
+            method = std::make_shared<DifferentialEvolution>(
+                logger,
+                must_non_negative_int64(deSize->text().toStdString()),
+                must_double(deF->text().toStdString(), positive<double>),
+                must_double(deCR->text().toStdString(), [](auto val) { return val >= 0 and val <= 1; }),
+                must_double(deStopEps->text().toStdString(), positive<double>),
+                must_int64(deSteps->text().toStdString(), true)
+            );
+            break;
+
+        case 5:
+            method = std::make_shared<ParticleSwarm>(
+                logger,
+                must_non_negative_int64(psoSize->text().toStdString()),
+                0.7298, 1.49618, 1.49618,
+                must_double(psoStopEps->text().toStdString(), positive<double>),
+                must_int64(psoSteps->text().toStdString(), true)
+            );
+            break;
+
+        case 6:
+            method = std::make_shared<ParallelNelderMead>(
+                logger,
+                must_double(pnmStopEps->text().toStdString(), positive<double>),
+                must_non_negative_int64(pnmParallelism->text().toStdString()),
+                must_int64(pnmEvaluations->text().toStdString(), true)
+            );
+            break;
+
+        case 7:
+            method = std::make_shared<Hybrid>(
+                logger,
+                must_int64(hybridSamples->text().toStdString(), true),
+                must_int64(hybridBasins->text().toStdString(), true),
+                must_int64(hybridEvaluations->text().toStdString(), true),
+                must_double(hybridStopEps->text().toStdString(), positive<double>)
+            );
+            break;
+
+        case 8:
+            method = std::make_shared<BranchAndBound>(
+                logger,
+                must_double(bnbStopEps->text().toStdString(), positive<double>),
+                must_int64(bnbBoxes->text().toStdString(), true)
+            );
+            break;
+
+        case 9:
+            method = std::make_shared<PatternSearch>(
+                logger,
+                must_double(psStopEps->text().toStdString(), positive<double>),
+                must_int64(psEvaluations->text().toStdString(), true),
+                must_double(psStep->text().toStdString(), positive<double>)
             );
             break;
 
@@ -76,6 +165,10 @@ public:
             throw std::logic_error("?!");
         }
 
+        if (otherSampler->currentIndex() != 0) {
+            method->with_sampler(make_sampler(otherSampler->currentText().toStdString()));
+        }
+
         auto parseArea = [&area](const std::vector<CoordinateWidget*>& areaWidget) {
             Point min, max;
             for (const auto& point : areaWidget) {
@@ -115,13 +208,31 @@ public:
             throw std::logic_error("?!");
         }
 
-        if (area->dimensions() != 2) {
-            flagDrawGraph->setChecked(false);
-        }
-
         return Experiment{method, area, function};
     }
 
+    // all the experiment settings as a string, equal strings mean equal experiments
+    [[nodiscard]]
+    std::string signature() const {
+        std::string ret;
+        for (const auto* comboBox : findChildren<QComboBox*>()) {
+            ret += std::to_string(comboBox->currentIndex()) + ';';
+        }
+        for (const auto* edit : findChildren<QLineEdit*>()) {
+            // the graph settings only change the picture
+            if (!flagDrawGraph->isAncestorOf(edit)) {
+                ret += edit->text().toStdString() + ';';
+            }
+        }
+        for (const auto* checkBox : findChildren<QCheckBox*>()) {
+            if (!flagDrawGraph->isAncestorOf(checkBox)) {
+                ret += checkBox->isChecked() ? "on;" : "off;";
+            }
+        }
+        ret += flagDrawGraph->isChecked() ? "draw" : "no draw";
+        return ret;
+    }
+
 private:
     QRadioButton* rectangleButton;
     QRadioButton* circleButton;
@@ -133,14 +244,60 @@ private:
     QLineEdit* nelderMeadGamme;
     QLineEdit* nelderMeadRho;
     QLineEdit* nelderMeadSigma;
+    QLineEdit* nelderMeadBudget;
+    QCheckBox* nelderMeadAdaptive;
     QWidget* pageRandomWalk;
     QLineEdit* randomWalkStopEps;
     QLineEdit* randomWalkSteps;
     QLineEdit* randomWalkMinSteps;
     QLineEdit* randomWalkP;
     QLineEdit* randomWalkDelta;
+    QCheckBox* randomWalkCoordinateWise;
+    QWidget* pageLBFGS;
+    QLineEdit* lbfgsStopEps;
+    QLineEdit* lbfgsMemory;
+    QLineEdit* lbfgsSteps;
     QVBoxLayout* pageNelderMeadLayout;
     QVBoxLayout* pageRandomWalkLayout;
+    QVBoxLayout* pageLBFGSLayout;
+    QWidget* pageCMAES;
+    QVBoxLayout* pageCMAESLayout;
+    QLineEdit* cmaesStopEps;
+    QLineEdit* cmaesRestarts;
+    QLineEdit* cmaesEvaluations;
+    QLineEdit* cmaesSigma;
+    QWidget* pageDE;
+    QVBoxLayout* pageDELayout;
+    QLineEdit* deStopEps;
+    QLineEdit* deSteps;
+    QLineEdit* deSize;
+    QLineEdit* deF;
+    QLineEdit* deCR;
+    QWidget* pagePSO;
+    QVBoxLayout* pagePSOLayout;
+    QLineEdit* psoStopEps;
+    QLineEdit* psoSteps;
+    QLineEdit* psoSize;
+    QWidget* pagePNM;
+    QVBoxLayout* pagePNMLayout;
+    QLineEdit* pnmStopEps;
+    QLineEdit* pnmParallelism;
+    QLineEdit* pnmEvaluations;
+    QWidget* pageHybrid;
+    QVBoxLayout* pageHybridLayout;
+    QLineEdit* hybridSamples;
+    QLineEdit* hybridBasins;
+    QLineEdit* hybridEvaluations;
+    QLineEdit* hybridStopEps;
+    QWidget* pageBnB;
+    QVBoxLayout* pageBnBLayout;
+    QLineEdit* bnbStopEps;
+    QLineEdit* bnbBoxes;
+    QWidget* pagePS;
+    QVBoxLayout* pagePSLayout;
+    QLineEdit* psStopEps;
+    QLineEdit* psEvaluations;
+    QLineEdit* psStep;
     QWidget* pageFunctionHimmelblau;
     QStackedWidget* functionStackedWidget;
     QVBoxLayout* pageFunctionHimmelblauLayout;
@@ -158,6 +315,9 @@ private:
     QGroupBox* flagDrawGraph;
     QLineEditWithLabel* drawGraphDensity;
     QLineEditWithLabel* drawPixelSize;
+    QLineEditWithLabel* drawSliceX;
+    QLineEditWithLabel* drawSliceY;
+    QCheckBox* drawSmallMultiples;
 
 
     QGroupBox* createGroupMethod() {
@@ -168,6 +328,14 @@ private:
         auto* comboBox = new QComboBox(this);
         comboBox->addItem(tr("Nelder-Mead"));
         comboBox->addItem(tr("Random Walk"));
+        comboBox->addItem(tr("L-BFGS"));
+        comboBox->addItem(tr("CMA-ES"));
+        comboBox->addItem(tr("Differential Evolution"));
+        comboBox->addItem(tr("Particle Swarm"));
+        comboBox->addItem(tr("Parallel Nelder-Mead"));
+        comboBox->addItem(tr("Sampling + Nelder-Mead"));
+        comboBox->addItem(tr("Branch and Bound"));
+        comboBox->addItem(tr("Pattern Search"));
         vboxLayout->addWidget(comboBox);
 
         methodStackedWidget = new QStackedWidget(this);
@@ -204,6 +372,20 @@ private:
         nelderMeadSigma->setText("0.5");
         pageNelderMeadLayout->addWidget(nelderMeadSigma);
 
+        nelderMeadAdaptive = new QCheckBox(tr("Adaptive Coefficients (Gao-Han, overrides the above)"), this);
+        pageNelderMeadLayout->addWidget(nelderMeadAdaptive);
+        connect(nelderMeadAdaptive, &QCheckBox::toggled, this, [this](const bool checked) {
+            nelderMeadAlpha->setEnabled(!checked);
+            nelderMeadGamme->setEnabled(!checked);
+            nelderMeadRho->setEnabled(!checked);
+            nelderMeadSigma->setEnabled(!checked);
+        });
+
+        pageNelderMeadLayout->addWidget(new QLabel("Max. Evaluations with Restarts (0 = a single descent)"));
+        nelderMeadBudget = new QLineEdit(this);
+        nelderMeadBudget->setText("0");
+        pageNelderMeadLayout->addWidget(nelderMeadBudget);
+
 
         // Page 2, Random Walk
         pageRandomWalk = new QWidget(this);
@@ -235,6 +417,192 @@ private:
         randomWalkDelta->setText("0.1s");
         pageRandomWalkLayout->addWidget(randomWalkDelta);
 
+        randomWalkCoordinateWise = new QCheckBox(tr("Move One Coordinate at a Time"), this);
+        pageRandomWalkLayout->addWidget(randomWalkCoordinateWise);
+
+
+        // Page 3, L-BFGS
+        pageLBFGS = new QWidget(this);
+        methodStackedWidget->addWidget(pageLBFGS);
+        pageLBFGSLayout = new QVBoxLayout(pageLBFGS);
+
+        pageLBFGSLayout->addWidget(new QLabel("Stop Eps. (projected gradient)"));
+        lbfgsStopEps = new QLineEdit(this);
+        lbfgsStopEps->setText("0.000001");
+        pageLBFGSLayout->addWidget(lbfgsStopEps);
+
+        pageLBFGSLayout->addWidget(new QLabel("Memory"));
+        lbfgsMemory = new QLineEdit(this);
+        lbfgsMemory->setText("7");
+        pageLBFGSLayout->addWidget(lbfgsMemory);
+
+        pageLBFGSLayout->addWidget(new QLabel("Max. Steps"));
+        lbfgsSteps = new QLineEdit(this);
+        lbfgsSteps->setText("1000");
+        pageLBFGSLayout->addWidget(lbfgsSteps);
+
+
+        // Page 4, CMA-ES
+        pageCMAES = new QWidget(this);
+        methodStackedWidget->addWidget(pageCMAES);
+        pageCMAESLayout = new QVBoxLayout(pageCMAES);
+
+        pageCMAESLayout->addWidget(new QLabel("Stop Eps."));
+        cmaesStopEps = new QLineEdit(this);
+        cmaesStopEps->setText("0.00000001");
+        pageCMAESLayout->addWidget(cmaesStopEps);
+
+        pageCMAESLayout->addWidget(new QLabel("IPOP Restarts"));
+        cmaesRestarts = new QLineEdit(this);
+        cmaesRestarts->setText("4");
+        pageCMAESLayout->addWidget(cmaesRestarts);
+
+        pageCMAESLayout->addWidget(new QLabel("Max. Evaluations"));
+        cmaesEvaluations = new QLineEdit(this);
+        cmaesEvaluations->setText("100000");
+        pageCMAESLayout->addWidget(cmaesEvaluations);
+
+        pageCMAESLayout->addWidget(new QLabel("Initial Sigma (fraction of the area)"));
+        cmaesSigma = new QLineEdit(this);
+        cmaesSigma->setText("0.3");
+        pageCMAESLayout->addWidget(cmaesSigma);
+
+
+        // Page 5, Differential Evolution
+        pageDE = new QWidget(this);
+        methodStackedWidget->addWidget(pageDE);
+        pageDELayout = new QVBoxLayout(pageDE);
+
+        pageDELayout->addWidget(new QLabel("Stop Eps."));
+        deStopEps = new QLineEdit(this);
+        deStopEps->setText("0.00000001");
+        pageDELayout->addWidget(deStopEps);
+
+        pageDELayout->addWidget(new QLabel("Max. Generations"));
+        deSteps = new QLineEdit(this);
+        deSteps->setText("1000");
+        pageDELayout->addWidget(deSteps);
+
+        pageDELayout->addWidget(new QLabel("Population (0 = 10 per dimension)"));
+        deSize = new QLineEdit(this);
+        deSize->setText("0");
+        pageDELayout->addWidget(deSize);
+
+        pageDELayout->addWidget(new QLabel("F"));
+        deF = new QLineEdit(this);
+        deF->setText("0.5");
+        pageDELayout->addWidget(deF);
+
+        pageDELayout->addWidget(new QLabel("CR"));
+        deCR = new QLineEdit(this);
+        deCR->setText("0.9");
+        pageDELayout->addWidget(deCR);
+
+
+        // Page 6, Particle Swarm
+        pagePSO = new QWidget(this);
+        methodStackedWidget->addWidget(pagePSO);
+        pagePSOLayout = new QVBoxLayout(pagePSO);
+
+        pagePSOLayout->addWidget(new QLabel("Stop Eps."));
+        psoStopEps = new QLineEdit(this);
+        psoStopEps->setText("0.00000001");
+        pagePSOLayout->addWidget(psoStopEps);
+
+        pagePSOLayout->addWidget(new QLabel("Max. Iterations"));
+        psoSteps = new QLineEdit(this);
+        psoSteps->setText("1000");
+        pagePSOLayout->addWidget(psoSteps);
+
+        pagePSOLayout->addWidget(new QLabel("Swarm Size (0 = auto)"));
+        psoSize = new QLineEdit(this);
+        psoSize->setText("0");
+        pagePSOLayout->addWidget(psoSize);
+
+
+        // Page 7, Parallel Nelder-Mead
+        pagePNM = new QWidget(this);
+        methodStackedWidget->addWidget(pagePNM);
+        pagePNMLayout = new QVBoxLayout(pagePNM);
+
+        pagePNMLayout->addWidget(new QLabel("Stop Eps."));
+        pnmStopEps = new QLineEdit(this);
+        pnmStopEps->setText("0.001");
+        pagePNMLayout->addWidget(pnmStopEps);
+
+        pagePNMLayout->addWidget(new QLabel("Vertices Updated at Once (0 = number of threads)"));
+        pnmParallelism = new QLineEdit(this);
+        pnmParallelism->setText("0");
+        pagePNMLayout->addWidget(pnmParallelism);
+
+        pagePNMLayout->addWidget(new QLabel("Max. Evaluations"));
+        pnmEvaluations = new QLineEdit(this);
+        pnmEvaluations->setText("100000");
+        pagePNMLayout->addWidget(pnmEvaluations);
+
+
+        // Page 8, Sampling + Nelder-Mead
+        pageHybrid = new QWidget(this);
+        methodStackedWidget->addWidget(pageHybrid);
+        pageHybridLayout = new QVBoxLayout(pageHybrid);
+
+        pageHybridLayout->addWidget(new QLabel("Samples"));
+        hybridSamples = new QLineEdit(this);
+        hybridSamples->setText("1000");
+        pageHybridLayout->addWidget(hybridSamples);
+
+        pageHybridLayout->addWidget(new QLabel("Basins (parallel descents)"));
+        hybridBasins = new QLineEdit(this);
+        hybridBasins->setText("4");
+        pageHybridLayout->addWidget(hybridBasins);
+
+        pageHybridLayout->addWidget(new QLabel("Max. Evaluations per Descent"));
+        hybridEvaluations = new QLineEdit(this);
+        hybridEvaluations->setText("10000");
+        pageHybridLayout->addWidget(hybridEvaluations);
+
+        pageHybridLayout->addWidget(new QLabel("Stop Eps."));
+        hybridStopEps = new QLineEdit(this);
+        hybridStopEps->setText("0.000001");
+        pageHybridLayout->addWidget(hybridStopEps);
+
+
+        // Page 9, Branch and Bound
+        pageBnB = new QWidget(this);
+        methodStackedWidget->addWidget(pageBnB);
+        pageBnBLayout = new QVBoxLayout(pageBnB);
+
+        pageBnBLayout->addWidget(new QLabel("Stop Eps. (certified gap)"));
+        bnbStopEps = new QLineEdit(this);
+        bnbStopEps->setText("0.000001");
+        pageBnBLayout->addWidget(bnbStopEps);
+
+        pageBnBLayout->addWidget(new QLabel("Max. Boxes"));
+        bnbBoxes = new QLineEdit(this);
+        bnbBoxes->setText("1000000");
+        pageBnBLayout->addWidget(bnbBoxes);
+
+
+        // Page 10, Pattern Search
+        pagePS = new QWidget(this);
+        methodStackedWidget->addWidget(pagePS);
+        pagePSLayout = new QVBoxLayout(pagePS);
+
+        pagePSLayout->addWidget(new QLabel("Stop Eps. (mesh size)"));
+        psStopEps = new QLineEdit(this);
+        psStopEps->setText("0.00000001");
+        pagePSLayout->addWidget(psStopEps);
+
+        pagePSLayout->addWidget(new QLabel("Max. Evaluations"));
+        psEvaluations = new QLineEdit(this);
+        psEvaluations->setText("100000");
+        pagePSLayout->addWidget(psEvaluations);
+
+        pagePSLayout->addWidget(new QLabel("Initial Mesh (fraction of the area)"));
+        psStep = new QLineEdit(this);
+        psStep->setText("0.1");
+        pagePSLayout->addWidget(psStep);
+
 
         connect(comboBox,
                 QOverload<int>::of(&QComboBox::currentIndexChanged),
@@ -328,7 +696,7 @@ private:
     }
 
     QGroupBox* createGraphConfiguration() {
-        flagDrawGraph = new QGroupBox(tr("Draw Graph (only for 2d)"));
+        flagDrawGraph = new QGroupBox(tr("Draw Graph (2d slices for Nd)"));
         flagDrawGraph->setCheckable(true);
         flagDrawGraph->setChecked(true);
 
@@ -337,6 +705,12 @@ private:
         vbox->addWidget(drawPixelSize);
         drawGraphDensity = new QLineEditWithLabel("Sample Density", "3", this);
         vbox->addWidget(drawGraphDensity);
+        drawSliceX = new QLineEditWithLabel("Slice X Axis", "0", this);
+        vbox->addWidget(drawSliceX);
+        drawSliceY = new QLineEditWithLabel("Slice Y Axis", "1", this);
+        vbox->addWidget(drawSliceY);
+        drawSmallMultiples = new QCheckBox(tr("All Axis Pairs"), this);
+        vbox->addWidget(drawSmallMultiples);
         vbox->addStretch(1);
         flagDrawGraph->setLayout(vbox);
 
@@ -345,6 +719,7 @@ private:
 
     QGroupBox* other;
     QLineEditWithLabel* otherSeed;
+    QComboBox* otherSampler;
 
     QGroupBox* createOther() {
         other = new QGroupBox(tr("Other Settings"));
@@ -353,6 +728,14 @@ private:
         otherSeed = new QLineEditWithLabel("Random Seed", "0", this);
         vbox->addWidget(otherSeed);
 
+        vbox->addWidget(new QLabel("Sampler of Initial and Global Points"));
+        otherSampler = new QComboBox(this);
+        otherSampler->addItem("uniform");
+        otherSampler->addItem("sobol");
+        otherSampler->addItem("halton");
+        otherSampler->addItem("lhs");
+        vbox->addWidget(otherSampler);
+
         other->setLayout(vbox);
         return other;
     }
@@ -51,6 +51,8 @@ struct GraphConfiguration {
     size_t sampleDensity;
     bool flagDraw;
     int randomSeed;
+    size_t sliceX, sliceY;
+    bool smallMultiples;
 };
 
 class QLineEditWithLabel final : public QWidget {
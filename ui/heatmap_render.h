@@ -0,0 +1,368 @@
+#ifndef HEATMAP_RENDER_H
+#define HEATMAP_RENDER_H
+
+#include "../internal/function.h"
+#include "../internal/parallel.h"
+
+#include <QImage>
+#include <QColor>
+#include <QPolygonF>
+#include <QPainter>
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+
+// Slice: 2-D cross-section of an N-D area over the axes x and y, the other coordinates are taken from `origin`
+struct Slice {
+    size_t x = 0, y = 1;
+    Point origin; // empty means the center of the area
+
+    bool operator==(const Slice& other) const = default;
+
+    // the origin filled in and checked against the area
+    [[nodiscard]] Slice normalized(const Area& area) const {
+        if (x >= area.dimensions() || y >= area.dimensions() || x == y) {
+            throw std::invalid_argument(fmt::format("Slice: axes ({}, {}) are invalid for {}",
+                                                    x, y, area.to_string()));
+        }
+        auto ret = *this;
+        if (ret.origin.size() != area.dimensions()) {
+            ret.origin = (area.min() + area.max()) / 2;
+        }
+        // the axes' own coordinates don't matter
+        ret.origin[x] = ret.origin[y] = 0;
+        return ret;
+    }
+
+    // the point at the (u, v) fractions of the slice
+    [[nodiscard]] Point point(const Area& area, const double u, const double v) const {
+        auto ret = origin;
+        ret[x] = area.percentile(x, u);
+        ret[y] = area.percentile(y, v);
+        return ret;
+    }
+};
+
+// HeatmapField: averaged function values of the cells of a heatmap, row 0 is the bottom one
+struct HeatmapField {
+    size_t columns = 0, rows = 0;
+    std::vector<double> values; // values[row * columns + column]
+};
+
+// evaluates `rate`-spaced sub-samples of every `pixel_size` cell of a width x height picture of the area's slice,
+// rows are evaluated in parallel, each one as a batch
+inline HeatmapField evaluate_heatmap(const FunctionI& function, const Area& area,
+                                     const size_t width, const size_t height,
+                                     const size_t pixel_size, const size_t rate, const Slice& slice = {}) {
+    const auto section = slice.normalized(area);
+    auto field = HeatmapField{};
+    field.columns = (width + pixel_size - 1) / pixel_size;
+    field.rows = (height + pixel_size - 1) / pixel_size;
+    field.values.resize(field.columns * field.rows);
+
+    auto& pool = ThreadPool::global();
+    pool.parallel_for(field.rows, pool.grain_for(field.rows), [&](const size_t begin, const size_t end) {
+        auto points = std::vector<Point>{};
+        for (size_t row = begin; row < end; row++) {
+            const auto y = row * pixel_size;
+            points.clear();
+            for (size_t x = 0; x < width; x += pixel_size) {
+                for (size_t i = x; i < x + pixel_size; i += rate) {
+                    for (size_t j = y; j < y + pixel_size; j += rate) {
+                        points.push_back(section.point(area, static_cast<double>(i) / width,
+                                                     static_cast<double>(j) / height));
+                    }
+                }
+            }
+
+            const auto values = function.evaluate_batch(points);
+            const auto per_cell = values.size() / field.columns;
+            for (size_t column = 0; column < field.columns; column++) {
+                double sum = 0;
+                for (size_t k = 0; k < per_cell; k++) {
+                    sum += values[column * per_cell + k];
+                }
+                field.values[row * field.columns + column] = sum / per_cell;
+            }
+        }
+    });
+
+    return field;
+}
+
+// Colormap: blue -> red "temperature" scale over [0, 100], precomputed into a lookup table
+class Colormap {
+    static constexpr size_t SIZE = 1024;
+    std::array<QRgb, SIZE> lut_{};
+
+public:
+    Colormap() {
+        for (size_t i = 0; i < SIZE; i++) {
+            const auto temperature = static_cast<double>(i) / SIZE;
+            const auto r = static_cast<int>(255 * std::pow(temperature, 3));
+            const auto b = static_cast<int>(255 * std::pow(1 - temperature, 3));
+            lut_[i] = qRgb(r, 0, b);
+        }
+    }
+
+    static const Colormap& instance() {
+        static const Colormap colormap;
+        return colormap;
+    }
+
+    // values which get the same (or a hardly distinguishable) colour
+    static bool indistinguishable(const double lo, const double hi) {
+        return lo >= 100 || hi <= 0 || hi - lo < 100.0 / SIZE;
+    }
+
+    [[nodiscard]] QRgb operator()(const double value) const {
+        const auto temperature = value / 100.0;
+        if (!(temperature > 0)) {
+            return lut_.front();
+        }
+        if (temperature >= 1) {
+            return lut_.back();
+        }
+        return lut_[static_cast<size_t>(temperature * SIZE)];
+    }
+};
+
+// one image pixel per field cell, flipped so the bottom row of the field is the bottom of the image
+inline QImage render_heatmap(const HeatmapField& field) {
+    auto image = QImage(static_cast<int>(field.columns), static_cast<int>(field.rows), QImage::Format_RGB32);
+    const auto& colormap = Colormap::instance();
+    for (size_t row = 0; row < field.rows; row++) {
+        auto* line = reinterpret_cast<QRgb*>(image.scanLine(static_cast<int>(field.rows - 1 - row)));
+        const auto* values = &field.values[row * field.columns];
+        for (size_t column = 0; column < field.columns; column++) {
+            line[column] = colormap(values[column]);
+        }
+    }
+    return image;
+}
+
+// Progressive version of evaluate_heatmap: the corners of the cells are sampled on grids of 32, 16, ... pixels
+// down to pixel_size, a finer grid reuses the samples of the coarser ones. If the corners of a coarse block
+// get indistinguishable colours its inner samples are interpolated instead of evaluated, so the coarse stages
+// show the varying parts of the field first. Interpolation can hide features smaller than a block, so the finest
+// grid evaluates every sample, and the final field is the exact one. on_stage gets the field and its cell size
+// after every stage; the last stage averages `rate`-spaced sub-samples, like evaluate_heatmap does.
+// Returns false if cancelled.
+inline bool evaluate_heatmap_progressive(const FunctionI& function, const Area& area,
+                                         const size_t width, const size_t height,
+                                         const size_t pixel_size, const size_t rate, const Slice& slice,
+                                         const std::function<bool()>& cancelled,
+                                         const std::function<void(const HeatmapField& field, size_t cell)>& on_stage) {
+    if (width == 0 || height == 0) {
+        return true;
+    }
+    const auto section = slice.normalized(area);
+
+    // grid of the cell corners at pixel_size, including the right and the top edges
+    const auto nx = (width + pixel_size - 1) / pixel_size + 1;
+    const auto ny = (height + pixel_size - 1) / pixel_size + 1;
+    auto grid = std::vector<double>(nx * ny);
+    auto flat = std::vector<char>(nx * ny); // the value is interpolated, not evaluated (not vector<bool>, rows are written concurrently)
+    auto sample = [&](const size_t c, const size_t r) {
+        return section.point(area, static_cast<double>(c * pixel_size) / width,
+                             static_cast<double>(r * pixel_size) / height);
+    };
+
+    size_t step = 1;
+    while (step * 2 * pixel_size <= 32) {
+        step *= 2;
+    }
+
+    auto& pool = ThreadPool::global();
+    for (auto k = step; k >= 1; k /= 2) {
+        auto on_level = [](const size_t i, const size_t level, const size_t n) { return i % level == 0 || i == n - 1; };
+
+        pool.parallel_for(ny, pool.grain_for(ny), [&](const size_t begin, const size_t end) {
+            auto points = std::vector<Point>{};
+            auto indexes = std::vector<size_t>{};
+            for (size_t r = begin; r < end; r++) {
+                if (cancelled() || !on_level(r, k, ny)) {
+                    continue;
+                }
+                points.clear();
+                indexes.clear();
+                for (size_t c = 0; c < nx; c++) {
+                    if (!on_level(c, k, nx)) {
+                        continue;
+                    }
+                    if (k != step && on_level(c, 2 * k, nx) && on_level(r, 2 * k, ny)) {
+                        if (k != 1 || !flat[r * nx + c]) {
+                            continue; // known from the coarser level
+                        }
+                        // the finest level evaluates the interpolated samples, so the final field is exact
+                    } else if (k != step && k != 1) {
+                        // the coarser block around, its corners are known
+                        const auto c0 = c / (2 * k) * 2 * k, c1 = std::min(c0 + 2 * k, nx - 1);
+                        const auto r0 = r / (2 * k) * 2 * k, r1 = std::min(r0 + 2 * k, ny - 1);
+                        const auto v00 = grid[r0 * nx + c0], v01 = grid[r0 * nx + c1];
+                        const auto v10 = grid[r1 * nx + c0], v11 = grid[r1 * nx + c1];
+                        const auto [lo, hi] = std::minmax({v00, v01, v10, v11});
+                        if (Colormap::indistinguishable(lo, hi)) {
+                            const auto tx = c1 == c0 ? 0.0 : static_cast<double>(c - c0) / (c1 - c0);
+                            const auto ty = r1 == r0 ? 0.0 : static_cast<double>(r - r0) / (r1 - r0);
+                            grid[r * nx + c] = (v00 * (1 - tx) + v01 * tx) * (1 - ty) + (v10 * (1 - tx) + v11 * tx) * ty;
+                            flat[r * nx + c] = 1;
+                            continue;
+                        }
+                    }
+                    points.push_back(sample(c, r));
+                    indexes.push_back(r * nx + c);
+                }
+                const auto values = function.evaluate_batch(points);
+                for (size_t i = 0; i < values.size(); i++) {
+                    grid[indexes[i]] = values[i];
+                    flat[indexes[i]] = 0;
+                }
+            }
+        });
+        if (cancelled()) {
+            return false;
+        }
+
+        auto field = HeatmapField{};
+        field.columns = (nx - 2) / k + 1;
+        field.rows = (ny - 2) / k + 1;
+        field.values.resize(field.columns * field.rows);
+        for (size_t row = 0; row < field.rows; row++) {
+            for (size_t column = 0; column < field.columns; column++) {
+                field.values[row * field.columns + column] = grid[row * k * nx + column * k];
+            }
+        }
+        if (k == 1 && rate >= pixel_size) {
+            on_stage(field, pixel_size);
+            return true; // a single sub-sample per cell, the corner one
+        }
+        on_stage(field, k * pixel_size);
+    }
+
+    // average the sub-samples of every cell
+    auto field = HeatmapField{};
+    field.columns = nx - 1;
+    field.rows = ny - 1;
+    field.values.resize(field.columns * field.rows);
+    pool.parallel_for(field.rows, pool.grain_for(field.rows), [&](const size_t begin, const size_t end) {
+        auto points = std::vector<Point>{};
+        for (size_t row = begin; row < end && !cancelled(); row++) {
+            points.clear();
+            auto cells = std::vector<size_t>{};
+            for (size_t column = 0; column < field.columns; column++) {
+                cells.push_back(column);
+                const auto x = column * pixel_size, y = row * pixel_size;
+                for (size_t i = x; i < x + pixel_size; i += rate) {
+                    for (size_t j = y; j < y + pixel_size; j += rate) {
+                        points.push_back(section.point(area, static_cast<double>(i) / width,
+                                                     static_cast<double>(j) / height));
+                    }
+                }
+            }
+            if (cells.empty()) {
+                continue;
+            }
+            const auto values = function.evaluate_batch(points);
+            const auto per_cell = values.size() / cells.size();
+            for (size_t k = 0; k < cells.size(); k++) {
+                double sum = 0;
+                for (size_t i = 0; i < per_cell; i++) {
+                    sum += values[k * per_cell + i];
+                }
+                field.values[row * field.columns + cells[k]] = sum / per_cell;
+            }
+        }
+    });
+    if (cancelled()) {
+        return false;
+    }
+    on_stage(field, pixel_size);
+    return true;
+}
+
+// Screen-space polyline of a path (projected on the slice axes) over a width x height picture of the area,
+// ready for a single drawPolyline.
+// Consecutive points falling into the same pixel are merged, the rest is simplified by Douglas–Peucker
+// with `tolerance` pixels. Points out of the area are kept (the painter clips them) and counted in `outside`.
+inline QPolygonF path_polyline(const Area& area, const std::vector<Point>& path, const int width, const int height,
+                               size_t* outside = nullptr, const Slice& slice = {}, const double tolerance = 0.5) {
+    const auto sx = slice.x, sy = slice.y;
+    auto merged = std::vector<QPointF>{};
+    merged.reserve(std::min<size_t>(path.size(), static_cast<size_t>(width) * height));
+    size_t out = 0;
+    for (const auto& point : path) {
+        if (point[sx] < area.min()[sx] || point[sx] > area.max()[sx]
+            || point[sy] < area.min()[sy] || point[sy] > area.max()[sy]) {
+            out += 1;
+        }
+        const auto x = (point[sx] - area.min()[sx]) / (area.max()[sx] - area.min()[sx]) * width;
+        const auto y = height - 1 - (point[sy] - area.min()[sy]) / (area.max()[sy] - area.min()[sy]) * height;
+        if (!merged.empty() && std::floor(merged.back().x()) == std::floor(x)
+            && std::floor(merged.back().y()) == std::floor(y)) {
+            continue;
+        }
+        merged.emplace_back(x, y);
+    }
+    if (outside != nullptr) {
+        *outside = out;
+    }
+    if (merged.size() <= 2) {
+        return QPolygonF(QList<QPointF>(merged.begin(), merged.end()));
+    }
+
+    // Douglas–Peucker, iterative
+    auto keep = std::vector<char>(merged.size());
+    keep.front() = keep.back() = 1;
+    auto stack = std::vector<std::pair<size_t, size_t>>{{0, merged.size() - 1}};
+    while (!stack.empty()) {
+        const auto [first, last] = stack.back();
+        stack.pop_back();
+
+        const auto a = merged[first], b = merged[last];
+        const auto dx = b.x() - a.x(), dy = b.y() - a.y();
+        const auto length2 = dx * dx + dy * dy;
+        double farthest = -1;
+        size_t index = first;
+        for (auto i = first + 1; i < last; i++) {
+            const auto& p = merged[i];
+            // to the segment, not the line through it: paths go back and forth beyond the ends
+            const auto t = length2 == 0
+                ? 0.0
+                : std::clamp(((p.x() - a.x()) * dx + (p.y() - a.y()) * dy) / length2, 0.0, 1.0);
+            const auto distance = std::hypot(p.x() - a.x() - t * dx, p.y() - a.y() - t * dy);
+            if (distance > farthest) {
+                farthest = distance;
+                index = i;
+            }
+        }
+        if (farthest > tolerance) {
+            keep[index] = 1;
+            stack.emplace_back(first, index);
+            stack.emplace_back(index, last);
+        }
+    }
+
+    auto ret = QPolygonF{};
+    for (size_t i = 0; i < merged.size(); i++) {
+        if (keep[i]) {
+            ret.append(merged[i]);
+        }
+    }
+    return ret;
+}
+
+
+// draws the path over a rendered heatmap, QImage is a paint device on its own, so no widget or event loop is needed
+inline void draw_path(QImage& image, const Area& area, const std::vector<Point>& path, const Slice& slice = {}) {
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(QColor{97, 222, 42}, std::max(1, image.width() / 800)));
+    painter.drawPolyline(path_polyline(area, path, image.width(), image.height(), nullptr, slice));
+}
+
+#endif //HEATMAP_RENDER_H
@@ -52,6 +52,16 @@ must_int64(const std::string& from, const bool positive) {
     return ret;
 }
 
+// an index, or a count where 0 turns the feature off (e.g. a budget)
+inline std::int64_t
+must_non_negative_int64(const std::string& from) {
+    auto [ret, ok] = parse_int<int64_t>(from, non_negative<std::int64_t>);
+    if (!ok) {
+        throw std::invalid_argument(fmt::format("couldn't parse a non-negative integer from '{}'", from));
+    }
+    return ret;
+}
+
 
 inline std::pair<double, bool>
 parse_double(const std::string& from,